@@ -0,0 +1,115 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include <typeindex>
+#include <vector>
+#include <dynaconf/include/Options.h>
+
+namespace dynaconf {
+
+	/// Bulk binding of command-line flags and environment to Options.
+	///
+	/// Flags are registered against classes once, then a single pass over
+	/// argv (and optionally the environment) selects an option for every
+	/// matching flag:
+	///
+	///	bind<Connection>( binder, "connection" );
+	///	binder.apply( scope, argc, argv );	// --connection=ZMQ
+	///
+	/// is equivalent to set<Connection>( scope, "ZMQ", options ), except
+	/// that all options are resolved and defined under one lock each.
+	/// Environment variables are matched as PREFIX + flag, upper-cased with
+	/// '-' replaced by '_', and are overridden by flags on the command line.
+	///
+	/// Binding is meant for startup: bind() must not race with apply().
+	///
+	class Binder {
+	public:
+		/// Outcome of apply().
+		///
+		struct Result {
+			std::size_t applied = 0;	///< Definitions set in the scope.
+			std::vector<std::string> unknown;	///< Arguments naming no bound flag.
+			std::vector<std::string> duplicate;	///< Arguments repeating an earlier flag.
+			std::vector<std::string> unresolved;	///< Arguments whose value names no option.
+			std::vector<std::string> defined;	///< Arguments for classes the scope already defines.
+
+			/// @return true if every argument was applied.
+			///
+			explicit operator bool ( void ) const { return unknown.empty() && duplicate.empty() && unresolved.empty() && defined.empty(); }
+		};
+
+		/// Create a binder resolving against a set of options.
+		///
+		/// @param source options to resolve flag values in.
+		///
+		Binder( const std::shared_ptr<Options> & source = Options::Global );
+
+		/// Bind a flag name (without leading dashes) to a class.
+		///
+		/// @param index of class selected by the flag.
+		/// @param flag name.
+		/// @return false if the flag or its variable name is already bound.
+		///
+		bool bind( const std::type_index & index, const std::string & flag );
+
+		/// Apply command-line flags to a scope in one batch.
+		///
+		/// argv[0] is skipped, arguments not starting with "--" are ignored,
+		/// and "--" ends flag parsing. "--flag" alone selects the option "".
+		///
+		/// @param scope to define selected options in.
+		/// @param argc count of arguments.
+		/// @param argv arguments as passed to main.
+		/// @return applied count and any rejected arguments.
+		///
+		Result apply( const std::shared_ptr<Scope> & scope, int argc, const char * const * argv ) const;
+
+		/// Apply environment variables, then command-line flags, in one batch.
+		///
+		/// @param scope to define selected options in.
+		/// @param argc count of arguments.
+		/// @param argv arguments as passed to main.
+		/// @param environment null-terminated NAME=VALUE entries, e.g. environ.
+		/// @param prefix required on variable names; unknown prefixed variables are reported.
+		/// @return applied count and any rejected arguments.
+		///
+		Result apply( const std::shared_ptr<Scope> & scope, int argc, const char * const * argv, const char * const * environment, const std::string & prefix ) const;
+
+	protected:
+		/// Flag binding, kept sorted by name for allocation-free lookup.
+		///
+		struct Entry {
+			std::string name;	///< Flag or normalized variable name.
+			std::size_t binding;	///< Index into bindings.
+		};
+
+		/// Find an entry by name.
+		///
+		/// @param entries to search.
+		/// @param name start of name.
+		/// @param length of name.
+		/// @return entry or nullptr.
+		///
+		static const Entry * find( const std::vector<Entry> & entries, const char * name, std::size_t length );
+
+		std::shared_ptr<Options> options;	///< Source of definitions.
+		std::vector<std::type_index> bindings;	///< Class selected by each bound flag.
+		std::vector<Entry> flags;	///< Flag names, sorted.
+		std::vector<Entry> variables;	///< Environment names less prefix, sorted.
+	};
+
+
+	/// Bind a flag name to a class.
+	///
+	/// @tparam Class selected by the flag.
+	/// @param binder to register with.
+	/// @param flag name without leading dashes.
+	/// @return false if the flag or its variable name is already bound.
+	///
+	template < typename Class >
+	bool bind( Binder & binder, const std::string & flag )
+	{
+		return binder.bind( std::type_index{ typeid(Class) }, flag );
+	}
+}
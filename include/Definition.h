@@ -1,7 +1,10 @@
 #pragma once
+#include <atomic>
 #include <memory>
 #include <typeindex>
 #include <typeinfo>
+#include <utility>
+#include <dynaconf/include/Reference.h>
 
 namespace dynaconf {
 
@@ -15,8 +18,25 @@ namespace dynaconf {
 	/// level of abstraction, they provide no concrete meaning. Provider
 	/// defines the primary interface: instantiate().
 	///
+	/// Definitions are intrusively reference counted so that scopes and
+	/// options hold them through a single pointer with no control block.
+	/// Definitions created through shared_ptr are adopted instead: while
+	/// References exist, a registry keeps the shared_ptr owner alive.
+	///
 	class Definition {
 	public:
+		Definition( void )
+		: references( 0 )
+		{}
+
+		/// Copies start with no references of their own.
+		///
+		Definition( const Definition & )
+		: references( 0 )
+		{}
+
+		Definition & operator = ( const Definition & ) { return *this; }
+
 		/// Virtual destructor for chaining...
 		///
 		virtual ~Definition( void ) {}
@@ -26,6 +46,45 @@ namespace dynaconf {
 		/// @return type_index of defined class.
 		///
 		virtual std::type_index index( void ) const = 0;
+
+		/// Add a reference--used by Reference.
+		///
+		void acquire( void ) const { references.fetch_add( 1, std::memory_order_relaxed ); }
+
+		/// Drop a reference--used by Reference.
+		///
+		/// @return true if this was the last reference.
+		///
+		bool release( void ) const
+		{
+			const unsigned int prior = references.fetch_sub( 1, std::memory_order_acq_rel );
+			if( prior == ( Shared | 1 ) )
+			{
+				disown();
+			}
+			return prior == 1;
+		}
+
+		/// Add a reference to a definition owned by a shared_ptr.
+		///
+		/// Supports code predating Reference. Each call takes a process-wide
+		/// mutex, and the first also inserts the owner into a global table,
+		/// so prefer passing a Reference from the make_* helpers.
+		///
+		/// @param owner to keep alive until the last reference is dropped.
+		///
+		void adopt( std::shared_ptr<const void> owner ) const;
+
+	private:
+		/// Flag on references marking a registered shared_ptr owner.
+		///
+		static constexpr unsigned int Shared = 1u << 31;
+
+		/// Drop the registered owner once no references remain.
+		///
+		void disown( void ) const;
+
+		mutable std::atomic<unsigned int> references;	///< Count of Reference owners.
 	};
 
 
@@ -97,12 +156,76 @@ namespace dynaconf {
 	/// @tparam Class defined by the singleton.
 	/// @tparam Implementation a.k.a. class of the instance.
 	/// @param instance provided by the singleton.
-	/// @return shared pointer to singleton.
+	/// @return reference to singleton.
 	///
 	template< typename Class, typename Implementation >
-	auto make_singleton( const std::shared_ptr<Implementation> & instance ) -> std::shared_ptr< Singleton<Class> >
+	auto make_singleton( const std::shared_ptr<Implementation> & instance ) -> Reference< Singleton<Class> >
 	{
-		return std::make_shared< Singleton<Class> >( instance );
+		return make_reference< Singleton<Class> >( instance );
+	}
+
+
+	/// Provide a singleton stored inside its definition.
+	///
+	/// The definition is the only allocation: no separate instance, control
+	/// block, or second shared_ptr as with Singleton. instantiate() returns
+	/// a shared_ptr aliasing the definition, keeping it alive, at the cost
+	/// of a control block per call--use Singleton where get<>() is hot.
+	///
+	/// instantiate() references itself intrusively, so the definition must
+	/// be Reference-owned: create it with make_inline_singleton().
+	///
+	/// @tparam Class struct or class provided by this definition.
+	///
+	template < typename Class >
+	class InlineSingleton : public Provider<Class> {
+	public:
+		InlineSingleton( const InlineSingleton & ) = delete;
+		InlineSingleton & operator = ( const InlineSingleton & ) = delete;
+
+		/// Virtual destructor for chaining...
+		///
+		virtual ~InlineSingleton( void ) {}
+
+		/// Return the singleton instance.
+		///
+		/// @param scope ignored.
+		/// @return shared pointer to the instance, sharing the definition.
+		///
+		virtual std::shared_ptr<Class> instantiate( const std::shared_ptr<const Scope> & )
+		{
+			const std::shared_ptr<Definition> owner = Reference<Definition>{ this };
+			return std::shared_ptr<Class>( owner, &instance );
+		}
+
+	private:
+		/// Construct the instance in place--see make_inline_singleton().
+		///
+		/// @param args forwarded to the constructor of Class.
+		///
+		template < typename ... Args >
+		explicit InlineSingleton( Args && ... args )
+		: instance( std::forward<Args>( args )... )
+		{}
+
+		template < typename Other, typename ... Args >
+		friend auto make_inline_singleton( Args && ... args ) -> Reference< InlineSingleton<Other> >;
+
+	protected:
+		Class instance;	///< Instance provided by this singleton.
+	};
+
+
+	/// Syntatic sugar for creating an InlineSingleton
+	///
+	/// @tparam Class defined by the singleton.
+	/// @param args forwarded to the constructor of Class.
+	/// @return reference to singleton.
+	///
+	template< typename Class, typename ... Args >
+	auto make_inline_singleton( Args && ... args ) -> Reference< InlineSingleton<Class> >
+	{
+		return Reference< InlineSingleton<Class> >( new InlineSingleton<Class>( std::forward<Args>( args )... ) );
 	}
 
 
@@ -145,12 +268,12 @@ namespace dynaconf {
 	/// @tparam Class defined by the singleton.
 	/// @tparam Functor that creates instances
 	/// @param functor l- or r-reference.
-	/// @return shared pointer to factory.
+	/// @return reference to factory.
 	///
 	template< typename Class, typename Functor >
-	auto make_factory( Functor && functor ) -> std::shared_ptr< Factory< Class, Functor > >
+	auto make_factory( Functor && functor ) -> Reference< Factory< Class, Functor > >
 	{
-		return std::make_shared< Factory<Class, Functor> >( std::forward<Functor>( functor ) );
+		return make_reference< Factory<Class, Functor> >( std::forward<Functor>( functor ) );
 	}
 
 
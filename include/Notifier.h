@@ -0,0 +1,138 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <typeindex>
+#include <vector>
+
+namespace dynaconf {
+
+	// Forward Declare notifier...
+	//
+	class Notifier;
+
+	/// Registration of interest in definition changes.
+	///
+	/// Subscriptions are created via Scope::subscribe() and stay active for
+	/// as long as the caller holds the returned pointer. Changes accumulate
+	/// until the notifier delivers them, so a burst of definitions arrives
+	/// as a single callback. The notifier is not kept alive by its
+	/// subscriptions--changes posted after it is destroyed are dropped.
+	///
+	class Subscription : public std::enable_shared_from_this<Subscription> {
+	public:
+		/// Callback receiving the batch of changed type_indexes.
+		///
+		using Callback = std::function<void( const std::vector<std::type_index> & )>;
+
+		/// Create a subscription for changes to any class.
+		///
+		/// @param receiver to invoke with batched changes.
+		/// @param dispatcher delivering the changes.
+		///
+		Subscription( Callback && receiver, const std::shared_ptr<Notifier> & dispatcher );
+
+		/// Create a subscription for changes to a single class.
+		///
+		/// @param index of class to watch.
+		/// @param receiver to invoke with batched changes.
+		/// @param dispatcher delivering the changes.
+		///
+		Subscription( const std::type_index & index, Callback && receiver, const std::shared_ptr<Notifier> & dispatcher );
+
+		/// Check if a change to a class concerns this subscription.
+		///
+		/// @param index of changed class.
+		/// @return true if the subscription should be notified.
+		///
+		inline bool matches( const std::type_index & index ) const { return ! filtered || filter == index; }
+
+		/// Record a change and schedule delivery if not already pending.
+		///
+		/// Repeated changes to a class coalesce into one entry per batch. Once
+		/// the notifier is gone, pending changes are dropped.
+		///
+		/// @param index of changed class.
+		///
+		void post( const std::type_index & index );
+
+		/// Hand pending changes to the callback--called by the notifier.
+		///
+		void deliver( void );
+
+	protected:
+		const bool filtered;	///< Only changes to filter are of interest.
+		const std::type_index filter;	///< Class of interest if filtered.
+		const Callback callback;	///< Receiver of batched changes.
+		const std::weak_ptr<Notifier> notifier;	///< Delivery mechanism.
+
+		std::mutex mutex;	///< Thread-safety for pending.
+		std::vector<std::type_index> pending;	///< Changes since last delivery.
+		bool scheduled;	///< Delivery is queued with the notifier.
+	};
+
+
+	/// Delivers subscription batches off of the writer's thread.
+	///
+	/// A single worker thread is started on first use, so programs that
+	/// never subscribe never pay for it. Callbacks run on that worker and
+	/// should not block on drain(). The worker shares its queue rather than
+	/// the notifier, so a callback may release the last notifier handle.
+	///
+	class Notifier {
+	public:
+		Notifier( void );
+
+		/// Stops and joins the worker--pending deliveries are discarded.
+		///
+		/// If destroyed by one of its own callbacks the worker is detached
+		/// instead, and exits once that delivery returns.
+		///
+		~Notifier( void );
+
+		/// Queue a subscription for delivery.
+		///
+		/// @param subscription with pending changes.
+		///
+		void schedule( std::weak_ptr<Subscription> && subscription );
+
+		/// Block until every queued delivery has been made.
+		///
+		void drain( void );
+
+		/// Default global notifier
+		///
+		static const std::shared_ptr<Notifier> Global;
+
+		// Worker is bound to this instance...
+		//
+		Notifier( const Notifier & ) = delete;
+		Notifier & operator = ( const Notifier & ) = delete;
+
+	protected:
+		/// State shared between the notifier and its worker.
+		///
+		struct Queue {
+			Queue( void ) : busy( false ), stopping( false ) {}
+
+			std::mutex mutex;	///< Thread-safety for queue and state.
+			std::condition_variable wake;	///< Signals work or shutdown to the worker.
+			std::condition_variable idle;	///< Signals an empty queue to drain().
+			std::deque< std::weak_ptr<Subscription> > pending;
+			bool busy;	///< Worker is delivering outside of the lock.
+			bool stopping;	///< Worker should exit.
+		};
+
+		/// Worker loop: deliver queued subscriptions until stopped.
+		///
+		/// @param queue shared with the notifier.
+		///
+		static void run( std::shared_ptr<Queue> queue );
+
+		const std::shared_ptr<Queue> queue;	///< Outlives the notifier while the worker runs.
+		std::thread worker;	///< Started lazily by schedule().
+	};
+}
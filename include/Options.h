@@ -1,4 +1,8 @@
 #pragma once
+#include <atomic>
+#include <string>
+#include <utility>
+#include <vector>
 #include <dynaconf/include/Scope.h>
 
 namespace dynaconf {
@@ -20,13 +24,38 @@ namespace dynaconf {
 	///
 	class Options {
 	public:
+		/// Create an empty set of options.
+		///
+		Options( void )
+		: Options( false )
+		{}
+
+		/// Create a set of options, optionally backed by export tables.
+		///
+		/// @param link if true, DYNACONF_EXPORT tables are indexed on use.
+		///
+		explicit Options( bool link );
+
 		/// Define an option for a class.
 		///
+		/// Explicit definitions take precedence over DYNACONF_EXPORT records
+		/// for the same class and key, whichever is indexed first. Export
+		/// tables are not indexed here, so static-init callers build none.
+		///
 		/// @param defintion to set.
 		/// @param key identifying that definition.
 		/// @return boolean indication of success.
 		///
-		bool define( std::shared_ptr<Definition> && definition, const std::string & key );
+		bool define( Reference<Definition> && definition, const std::string & key );
+
+		/// Define an option held by a shared_ptr--@see Definition::adopt().
+		///
+		/// @param defintion to set.
+		/// @param key identifying that definition.
+		/// @return boolean indication of success.
+		///
+		template < typename DefinitionType >
+		bool define( const std::shared_ptr<DefinitionType> & definition, const std::string & key ) { return define( Reference<Definition>{ definition }, key ); }
 
 		/// Resolve an option for a class.
 		///
@@ -34,7 +63,17 @@ namespace dynaconf {
 		/// @param key identifying a definition.
 		/// @return pointer to definition or nullptr.
 		///
-		std::shared_ptr<Definition> resolve( const std::type_index & index, const std::string & key ) const;
+		Reference<Definition> resolve( const std::type_index & index, const std::string & key ) const;
+
+		/// Resolve several options under a single lock--see Binder.
+		///
+		/// Keys are null-terminated strings, e.g. pointing into argv, so
+		/// callers need not allocate a std::string per request.
+		///
+		/// @param requests of type_index and key pairs.
+		/// @return definition or nullptr for each request, in order.
+		///
+		std::vector< Reference<Definition> > resolve( const std::vector< std::pair<std::type_index, const char *> > & requests ) const;
 
 		/// Default global option set
 		///
@@ -50,6 +89,9 @@ namespace dynaconf {
 		///
 		///   set<MyType>( scope, "MyType", Options::Global );
 		///
+		/// Each export locks and updates the options during static
+		/// initialization; prefer DYNACONF_EXPORT, which doesn't.
+		///
 		/// TODO: Evaluate dropping this global linkage...
 		///
 		class Export {
@@ -64,21 +106,104 @@ namespace dynaconf {
 			/// @param options to export to -- default global.
 			///
 			template < typename DefinitionType >
+			Export( Reference<DefinitionType> && definition, const std::string & key, const std::shared_ptr<Options> & options = Global )
+			: valid( set( options, key, definition ) )
+			{}
+
+			/// Export a definition held by a shared_ptr--@see Definition::adopt().
+			///
+			template < typename DefinitionType >
 			Export( std::shared_ptr<DefinitionType> && definition, const std::string & key, const std::shared_ptr<Options> & options = Global )
 			: valid( set( options, key, definition ) )
 			{}
 		};
 
+		/// Constant export entry placed in a linker-collected table.
+		///
+		struct Record {
+			const char * key;	///< Key associated with definition.
+			Reference<Definition> (*make)( void );	///< Builds the definition on indexing.
+		};
+
+		/// Bounds of one loaded module's export records.
+		///
+		struct Table {
+			const Record * begin;
+			const Record * end;
+			Table * next;	///< Previously enlisted table.
+		};
+
+		/// Per-module anchor enlisting its export table when loaded.
+		///
+		/// Hidden visibility gives each executable and shared library its
+		/// own instance, so plugins enlist as they are dlopen()ed. Modules
+		/// with exports can never be unloaded: enlisting marks them
+		/// RTLD_NODELETE, so dlclose() leaves them mapped.
+		///
+		template < typename = void >
+		struct __attribute__(( visibility( "hidden" ) )) Module {
+			static Table table;	///< This module's records.
+			static const bool anchored;	///< Forces enlisting at load.
+		};
+
+		/// Publish a module's table for lazy indexing--lock-free.
+		///
+		/// @param table to publish.
+		/// @return true.
+		///
+		static bool enlist( Table * table );
+
 	protected:
+		/// Index tables enlisted since the last call--mutex must be held.
+		///
+		void absorb( void ) const;
+
+		/// Insert a definition--mutex must be held.
+		///
+		/// @param definition to set.
+		/// @param key identifying that definition.
+		/// @param exported if from an export record, which never replaces.
+		/// @return boolean indication of success.
+		///
+		bool insert( Reference<Definition> && definition, const std::string & key, bool exported ) const;
+
+		static std::atomic<Table *> Tables;	///< Most recently enlisted table.
+
+		/// Definition of an option and where it came from.
+		///
+		struct Entry {
+			Reference<Definition> definition;
+			bool exported;	///< From an export record--explicit defines replace it.
+		};
+
 		/// Collection of definitions sharing the same type_index.
 		/// 
 		struct Cluster {
-			std::unordered_map<std::string, std::shared_ptr<Definition> > definitions;
+			std::unordered_map<std::string, Entry > definitions;
 		};
 		
+		const bool linked;	///< Index export tables on use.
 		mutable std::mutex mutex;
-		std::unordered_map<std::type_index, Cluster > clusters;
+		mutable Table * indexed;	///< Most recent table already indexed.
+		mutable std::unordered_map<std::type_index, Cluster > clusters;	///< Mutable for lazy indexing.
 	};
+}
+
+
+// Linker-provided bounds of this module's export section.
+//
+extern "C" {
+	extern const dynaconf::Options::Record __start_dynaconf_exports[] __attribute__(( visibility( "hidden" ) ));
+	extern const dynaconf::Options::Record __stop_dynaconf_exports[] __attribute__(( visibility( "hidden" ) ));
+}
+
+namespace dynaconf {
+
+	template < typename Unused >
+	Options::Table Options::Module<Unused>::table{ __start_dynaconf_exports, __stop_dynaconf_exports, nullptr };
+
+	template < typename Unused >
+	const bool Options::Module<Unused>::anchored = Options::enlist( &Options::Module<Unused>::table );
 
 
 	/// Provide an option for a definition.
@@ -90,9 +215,24 @@ namespace dynaconf {
 	/// @return boolean indication of success.
 	///
 	template < typename DefinitionType >
+	bool set( const std::shared_ptr<Options> & options, const std::string & key, const Reference<DefinitionType> & definition )
+	{
+		return options->define( Reference<Definition>{ definition }, key );
+	}
+
+
+	/// Provide an option held by a shared_ptr--@see Definition::adopt().
+	///
+	/// @tparam DefinitionType type of definition--deduced.
+	/// @param options to add option to.
+	/// @param key for this option.
+	/// @param definition to set.
+	/// @return boolean indication of success.
+	///
+	template < typename DefinitionType >
 	bool set( const std::shared_ptr<Options> & options, const std::string & key, const std::shared_ptr<DefinitionType> & definition )
 	{
-		return options->define( std::static_pointer_cast<Definition>( definition ), key );
+		return options->define( definition, key );
 	}
 
 
@@ -101,13 +241,13 @@ namespace dynaconf {
 	/// @tparam Class to resolve.
 	/// @param options to query.
 	/// @param key for definition.
-	/// @return Provider<Class> pointer or nullptr.
+	/// @return Provider<Class> reference or nullptr.
 	///
 	template < typename Class >
-	auto get( const std::shared_ptr<Options> & options, const std::string & key ) -> std::shared_ptr< Provider<Class> >
+	auto get( const std::shared_ptr<Options> & options, const std::string & key ) -> Reference< Provider<Class> >
 	{
 		auto definition = options->resolve( std::type_index{ typeid(Class) }, key );
-		return std::dynamic_pointer_cast< Provider<Class> >( definition );
+		return dynamic_reference_cast< Provider<Class> >( definition );
 	}
 
 
@@ -133,3 +273,27 @@ namespace dynaconf {
 		}
 	}	
 }
+
+
+/// Export a definition to Options::Global via a link-time table.
+///
+/// Nothing runs per export during static initialization: the record is
+/// constant data collected by the linker, and the definition is built
+/// when Options::Global is first used after the module loads.
+/// Definitions must not use Options::Global while being built.
+///
+/// Example:
+///
+///   DYNACONF_EXPORT( myExport, "MyType", make_singleton<MyType>( std::make_shared<MyType>() ) );
+///
+///   /* ... */
+///
+///   set<MyType>( scope, "MyType", Options::Global );
+///
+#define DYNACONF_EXPORT( name, key, definition ) \
+	static ::dynaconf::Reference< ::dynaconf::Definition > name##_make( void ) \
+	{ \
+		static_cast<void>( ::dynaconf::Options::Module<>::anchored ); \
+		return ::dynaconf::Reference< ::dynaconf::Definition >{ definition }; \
+	} \
+	static const ::dynaconf::Options::Record name __attribute__(( section( "dynaconf_exports" ), used )) = { key, &name##_make }
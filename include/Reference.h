@@ -0,0 +1,230 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace dynaconf {
+
+	/// Deleter of shared_ptrs converted from a Reference.
+	///
+	/// Holds the converted reference's count until the shared_ptr is
+	/// done, and lets Reference recognize such shared_ptrs when adopting.
+	///
+	struct Retainer {
+		void * object;	///< Referenced object.
+		void (*drop)( void * );	///< Releases object's reference.
+
+		template < typename Type >
+		void operator() ( Type * ) const { drop( object ); }
+	};
+
+
+	/// Intrusive reference-counting pointer.
+	///
+	/// Unlike shared_ptr, the count lives in the referenced object, so
+	/// ownership costs one pointer and no separate control block. Type
+	/// must provide acquire() and release(), the latter returning true
+	/// when the last reference is dropped, and adopt() to share ownership
+	/// with a shared_ptr.
+	///
+	/// For compatibility, references convert to and from shared_ptr. Both
+	/// directions are for call sites predating Reference and cost a
+	/// shared_ptr control block or a registry entry respectively.
+	///
+	/// @tparam Type referenced.
+	///
+	template < typename Type >
+	class Reference {
+	public:
+		/// Create an empty reference.
+		///
+		Reference( std::nullptr_t = nullptr )
+		: pointer( nullptr )
+		{}
+
+		/// Take a reference to an object--typically fresh from new.
+		///
+		/// @param object to reference or nullptr.
+		///
+		explicit Reference( Type * object )
+		: pointer( object )
+		{
+			if( pointer )
+			{
+				pointer->acquire();
+			}
+		}
+
+		/// Share ownership of an object held by a shared_ptr.
+		///
+		/// @param shared owner of the object.
+		///
+		template < typename Other, typename = typename std::enable_if<std::is_convertible<Other *, Type *>::value>::type >
+		explicit Reference( const std::shared_ptr<Other> & shared )
+		: pointer( shared.get() )
+		{
+			if( ! pointer )
+			{
+				return;
+			}
+			if( std::get_deleter<Retainer>( shared ) )
+			{
+				// Converted from a Reference: the count is already intrusive.
+				//
+				pointer->acquire();
+			}
+			else
+			{
+				pointer->adopt( std::shared_ptr<const void>{ shared } );
+			}
+		}
+
+		Reference( const Reference & other )
+		: Reference( other.pointer )
+		{}
+
+		Reference( Reference && other )
+		: pointer( other.pointer )
+		{
+			other.pointer = nullptr;
+		}
+
+		/// Convert from a reference to a derived class.
+		///
+		template < typename Other, typename = typename std::enable_if<std::is_convertible<Other *, Type *>::value>::type >
+		Reference( const Reference<Other> & other )
+		: Reference( other.get() )
+		{}
+
+		/// Convert from a reference to a derived class.
+		///
+		template < typename Other, typename = typename std::enable_if<std::is_convertible<Other *, Type *>::value>::type >
+		Reference( Reference<Other> && other )
+		: pointer( other.detach() )
+		{}
+
+		~Reference( void )
+		{
+			reset();
+		}
+
+		Reference & operator = ( Reference other )
+		{
+			std::swap( pointer, other.pointer );
+			return *this;
+		}
+
+		/// Drop the reference, deleting the object if it was the last.
+		///
+		void reset( void )
+		{
+			if( pointer && pointer->release() )
+			{
+				delete pointer;
+			}
+			pointer = nullptr;
+		}
+
+		/// Give up ownership without releasing--for conversions.
+		///
+		/// @return previously referenced object.
+		///
+		Type * detach( void )
+		{
+			Type * result = pointer;
+			pointer = nullptr;
+			return result;
+		}
+
+		/// Convert to a shared_ptr holding this reference.
+		///
+		/// @return shared_ptr to the object or nullptr.
+		///
+		template < typename Other, typename = typename std::enable_if<std::is_convertible<Type *, Other *>::value>::type >
+		operator std::shared_ptr<Other> ( void ) const
+		{
+			if( ! pointer )
+			{
+				return std::shared_ptr<Other>{ nullptr };
+			}
+			pointer->acquire();
+			return std::shared_ptr<Other>( pointer, Retainer{ const_cast<void *>( static_cast<const void *>( pointer ) ), &Reference::drop } );
+		}
+
+		Type * get( void ) const { return pointer; }
+		Type * operator -> ( void ) const { return pointer; }
+		Type & operator * ( void ) const { return *pointer; }
+		explicit operator bool ( void ) const { return pointer != nullptr; }
+
+	protected:
+		/// Release a reference held by a Retainer.
+		///
+		/// @param object referenced.
+		///
+		static void drop( void * object )
+		{
+			Reference held;
+			held.pointer = static_cast<Type *>( object );
+		}
+
+		Type * pointer;	///< Referenced object or nullptr.
+	};
+
+
+	template < typename Left, typename Right >
+	bool operator == ( const Reference<Left> & left, const Reference<Right> & right ) { return left.get() == right.get(); }
+
+	template < typename Left, typename Right >
+	bool operator != ( const Reference<Left> & left, const Reference<Right> & right ) { return left.get() != right.get(); }
+
+	template < typename Left, typename Right >
+	bool operator == ( const Reference<Left> & left, const std::shared_ptr<Right> & right ) { return left.get() == right.get(); }
+
+	template < typename Left, typename Right >
+	bool operator != ( const Reference<Left> & left, const std::shared_ptr<Right> & right ) { return left.get() != right.get(); }
+
+	template < typename Left, typename Right >
+	bool operator == ( const std::shared_ptr<Left> & left, const Reference<Right> & right ) { return left.get() == right.get(); }
+
+	template < typename Left, typename Right >
+	bool operator != ( const std::shared_ptr<Left> & left, const Reference<Right> & right ) { return left.get() != right.get(); }
+
+	template < typename Type >
+	bool operator == ( const Reference<Type> & left, std::nullptr_t ) { return left.get() == nullptr; }
+
+	template < typename Type >
+	bool operator != ( const Reference<Type> & left, std::nullptr_t ) { return left.get() != nullptr; }
+
+	template < typename Type >
+	bool operator == ( std::nullptr_t, const Reference<Type> & right ) { return right.get() == nullptr; }
+
+	template < typename Type >
+	bool operator != ( std::nullptr_t, const Reference<Type> & right ) { return right.get() != nullptr; }
+
+
+	/// Allocate an object and take the first reference to it.
+	///
+	/// @tparam Type to construct.
+	/// @param args forwarded to the constructor.
+	/// @return reference to the new object.
+	///
+	template < typename Type, typename ... Args >
+	Reference<Type> make_reference( Args && ... args )
+	{
+		return Reference<Type>( new Type( std::forward<Args>( args )... ) );
+	}
+
+
+	/// Cast a reference down the class hierarchy with checking.
+	///
+	/// @tparam Type to cast to.
+	/// @param reference to cast.
+	/// @return reference of requested type or nullptr.
+	///
+	template < typename Type, typename Other >
+	Reference<Type> dynamic_reference_cast( const Reference<Other> & reference )
+	{
+		return Reference<Type>( dynamic_cast<Type *>( reference.get() ) );
+	}
+}
@@ -0,0 +1,612 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <new>
+#include <unordered_map>
+#include <utility>
+#include <dynaconf/include/Scope.h>
+
+namespace dynaconf {
+
+	/// Allocator placing each allocation on its own cache lines.
+	///
+	/// Replicas are allocated with it directly, so each instance starts a
+	/// line, and so are their shared_ptr control blocks, so reference
+	/// counts share no line with other replicas or unrelated heap data.
+	/// Sizes are rounded up to whole lines for the same reason.
+	///
+	/// @tparam Type allocated.
+	///
+	template < typename Type >
+	class CacheAligned {
+	public:
+		using value_type = Type;
+
+		static constexpr std::size_t Line = 64;	///< Assumed cache line size.
+
+		CacheAligned( void ) {}
+
+		template < typename Other >
+		CacheAligned( const CacheAligned<Other> & ) {}
+
+		/// Allocate line-aligned, line-padded storage.
+		///
+		/// The line preceding the aligned block records the raw pointer.
+		///
+		/// @param count of Type to allocate.
+		/// @return aligned storage.
+		///
+		Type * allocate( std::size_t count )
+		{
+			const std::size_t bytes = ( count * sizeof( Type ) + Line - 1 ) / Line * Line;
+			void * raw = std::malloc( bytes + 2 * Line );
+			if( ! raw )
+			{
+				throw std::bad_alloc{};
+			}
+			const auto address = ( reinterpret_cast<std::uintptr_t>( raw ) + 2 * Line - 1 ) / Line * Line;
+			reinterpret_cast<void **>( address )[ -1 ] = raw;
+			return reinterpret_cast<Type *>( address );
+		}
+
+		/// Release storage from allocate().
+		///
+		/// @param pointer to release.
+		///
+		void deallocate( Type * pointer, std::size_t )
+		{
+			std::free( reinterpret_cast<void **>( pointer )[ -1 ] );
+		}
+
+		template < typename Other >
+		bool operator == ( const CacheAligned<Other> & ) const { return true; }
+
+		template < typename Other >
+		bool operator != ( const CacheAligned<Other> & ) const { return false; }
+	};
+
+
+	/// Non-template support for replicated providers.
+	///
+	class Replication {
+	public:
+		/// Thread's cached replica of one provider.
+		///
+		/// Holds no reference to the replica itself, so a stale entry pins
+		/// only the provider's small lifetime token, never the replica.
+		///
+		struct Cached {
+			std::weak_ptr<void> provider;	///< Expires with the provider.
+			void * instance;	///< Replica, valid while its provider lives.
+			const void * owner;	///< Provider's shared_ptr to the replica.
+		};
+
+		/// Allocate a process-unique identity for a provider.
+		///
+		/// @return identity never reused by another provider.
+		///
+		static std::uint64_t identify( void );
+
+		/// Calling thread's replicas keyed by provider identity.
+		///
+		/// @return thread-local table.
+		///
+		static std::unordered_map< std::uint64_t, Cached > & local( void );
+
+		/// Token of the calling thread, expiring when the thread exits.
+		///
+		/// @return weak token.
+		///
+		static std::weak_ptr<void> thread( void );
+
+		/// Index of the CPU running the calling thread.
+		///
+		/// @return CPU index, or 0 where unsupported.
+		///
+		static unsigned int cpu( void );
+
+		/// Number of configured CPUs.
+		///
+		/// @return upper bound on cpu() + 1.
+		///
+		static unsigned int cpus( void );
+	};
+
+
+	/// Abstract base for providers keeping several instances of a class.
+	///
+	/// get<>() returns the caller's local replica; visit() walks all of
+	/// them so per-replica state can be aggregated.
+	///
+	/// get<>() still resolves through the scope, taking its lock and the
+	/// provider's reference count. Hot loops should resolve the provider
+	/// once with get_replicated<>() and call local(), which touches only
+	/// thread- or CPU-local state.
+	///
+	/// @tparam Class struct or class provided by this definition.
+	///
+	template < typename Class >
+	class Replicated : public Provider<Class> {
+	public:
+		/// Virtual destructor for chaining...
+		///
+		virtual ~Replicated( void ) {}
+
+		/// Call visitor on every replica built so far.
+		///
+		/// Replicas may be in concurrent use by their owners; the visitor
+		/// must tolerate that.
+		///
+		/// @param visitor invoked with each replica.
+		///
+		virtual void visit( const std::function<void( Class & )> & visitor ) = 0;
+
+		/// Return the caller's replica without locking or counting.
+		///
+		/// The replica remains valid while the caller holds the provider.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return caller's replica.
+		///
+		virtual Class & local( const std::shared_ptr<const Scope> & scope ) = 0;
+
+		/// Fold and free replicas whose owners are gone.
+		///
+		/// @param fold invoked with each replica before it is freed.
+		/// @return number of replicas freed.
+		///
+		virtual std::size_t retire( const std::function<void( Class & )> & fold ) = 0;
+
+	protected:
+		/// Destroy and free a replica from align().
+		///
+		struct Unalign {
+			void operator() ( Class * instance ) const
+			{
+				instance->~Class();
+				CacheAligned<Class>{}.deallocate( instance, 1 );
+			}
+		};
+
+		/// Construct a replica at the start of a cache line.
+		///
+		/// Unlike allocate_shared, which would put the control block ahead
+		/// of the instance, the two are allocated separately.
+		///
+		/// @param args forwarded to the constructor of Class.
+		/// @return replica on its own cache lines.
+		///
+		template < typename ... Args >
+		static std::shared_ptr<Class> align( Args && ... args )
+		{
+			CacheAligned<Class> allocator;
+			Class * storage = allocator.allocate( 1 );
+			Class * instance;
+			try
+			{
+				instance = new( storage ) Class( std::forward<Args>( args )... );
+			}
+			catch( ... )
+			{
+				allocator.deallocate( storage, 1 );
+				throw;
+			}
+			return std::shared_ptr<Class>( instance, Unalign{}, allocator );
+		}
+
+		/// Build a replica from a functor returning a Class by value.
+		///
+		/// @param functor taking the scope.
+		/// @param scope passed to functor.
+		/// @return replica on its own cache lines.
+		///
+		template < typename Functor >
+		static auto build( Functor & functor, const std::shared_ptr<const Scope> & scope, int )
+			-> decltype( void( Class( functor( scope ) ) ), std::shared_ptr<Class>() )
+		{
+			return align( functor( scope ) );
+		}
+
+		/// Build a default-constructed replica in place, then initialize it.
+		///
+		/// Suits classes that can't be moved, e.g. those holding atomics.
+		///
+		/// @param functor taking the replica and the scope.
+		/// @param scope passed to functor.
+		/// @return replica on its own cache lines.
+		///
+		template < typename Functor >
+		static auto build( Functor & functor, const std::shared_ptr<const Scope> & scope, long )
+			-> decltype( void( functor( std::declval<Class &>(), scope ) ), std::shared_ptr<Class>() )
+		{
+			auto instance = align();
+			functor( *instance, scope );
+			return instance;
+		}
+	};
+
+
+	/// Functor leaving default-constructed replicas as they are.
+	///
+	struct InPlace {
+		template < typename Class >
+		void operator() ( Class &, const std::shared_ptr<const Scope> & ) const {}
+	};
+
+
+	/// Provide one lazily built instance of a class per thread.
+	///
+	/// The functor builds a replica from the first calling scope on each
+	/// thread: either returning it by value, or initializing one that was
+	/// default-constructed in place (for classes that can't move).
+	///
+	/// NOTE: Replicas outlive their threads so visit() still sees their
+	/// contributions. Programs that keep creating threads must call
+	/// retire() periodically to fold exited threads' replicas into a
+	/// survivor and free them; otherwise replicas accumulate without bound.
+	///
+	/// @tparam Class defined by the provider.
+	/// @tparam Functor returning a Class, or initializing a Class &, given the scope.
+	///
+	template < typename Class, typename Functor >
+	class PerThread : public Replicated<Class>, protected Functor {
+	public:
+		/// Virtual destructor for chaining...
+		///
+		virtual ~PerThread( void ) {}
+
+		/// Return the calling thread's replica, building it if needed.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return shared pointer to thread's replica.
+		///
+		virtual std::shared_ptr<Class> instantiate( const std::shared_ptr<const Scope> & scope )
+		{
+			auto & table = Replication::local();
+			auto entry = table.find( identity );
+			if( entry != table.end() )
+			{
+				return *static_cast<const std::shared_ptr<Class> *>( entry->second.owner );
+			}
+			return create( table, scope );
+		}
+
+		/// Return the calling thread's replica without locking or counting.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return thread's replica.
+		///
+		virtual Class & local( const std::shared_ptr<const Scope> & scope )
+		{
+			auto & table = Replication::local();
+			auto entry = table.find( identity );
+			if( entry != table.end() )
+			{
+				return *static_cast<Class *>( entry->second.instance );
+			}
+			return *create( table, scope );
+		}
+
+		/// Call visitor on every replica built so far.
+		///
+		/// @param visitor invoked with each replica.
+		///
+		virtual void visit( const std::function<void( Class & )> & visitor )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			for( auto & replica : replicas )
+			{
+				visitor( *replica.instance );
+			}
+		}
+
+		/// Fold and free replicas of threads that have exited.
+		///
+		/// @param fold invoked with each replica before it is freed.
+		/// @return number of replicas freed.
+		///
+		virtual std::size_t retire( const std::function<void( Class & )> & fold )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			std::size_t result = 0;
+			for( auto replica = replicas.begin(); replica != replicas.end(); )
+			{
+				if( replica->thread.expired() )
+				{
+					fold( *replica->instance );
+					replica = replicas.erase( replica );
+					++result;
+				}
+				else
+				{
+					++replica;
+				}
+			}
+			return result;
+		}
+
+		///! Use deduction to forward l- and r-references.
+		///
+		/// @tparam Initializer deduced type, likely Functor.
+		/// @param initializer for Functor instance.
+		///
+		template < typename Initializer >
+		PerThread( Initializer && initializer )
+		: Functor( std::forward<Initializer>( initializer ) )
+		, identity( Replication::identify() )
+		, lifetime( std::make_shared<char>() )
+		{}
+
+	protected:
+		/// Build and cache the calling thread's replica.
+		///
+		/// @param table of the calling thread.
+		/// @param scope used to build the replica.
+		/// @return new replica.
+		///
+		std::shared_ptr<Class> create( std::unordered_map< std::uint64_t, Replication::Cached > & table, const std::shared_ptr<const Scope> & scope )
+		{
+			auto instance = Replicated<Class>::build( static_cast<Functor &>( *this ), scope, 0 );
+			const std::shared_ptr<Class> * owner;
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				replicas.push_back( Replica{ Replication::thread(), instance } );
+				owner = &replicas.back().instance;
+			}
+
+			// Entries of destroyed providers expire; sweep them while here.
+			//
+			for( auto iter = table.begin(); iter != table.end(); )
+			{
+				iter = iter->second.provider.expired() ? table.erase( iter ) : std::next( iter );
+			}
+			table[ identity ] = Replication::Cached{ lifetime, instance.get(), owner };
+			return instance;
+		}
+
+		/// Replica and the thread it belongs to.
+		///
+		struct Replica {
+			std::weak_ptr<void> thread;	///< Expires when the thread exits.
+			std::shared_ptr<Class> instance;
+		};
+
+		const std::uint64_t identity;	///< Key into thread-local tables.
+		const std::shared_ptr<void> lifetime;	///< Token expiring thread-local entries.
+		std::mutex mutex;	///< Thread-safety for replicas.
+		std::list<Replica> replicas;	///< Owning list of all replicas--stable for Cached::owner.
+	};
+
+
+	/// Provide one lazily built instance of a class per CPU.
+	///
+	/// Threads running on the same CPU share a replica, so the class must
+	/// tolerate occasional concurrent use (e.g. after migration), but
+	/// contention stays local to one core.
+	///
+	/// @tparam Class defined by the provider.
+	/// @tparam Functor returning a Class, or initializing a Class &, given the scope.
+	///
+	template < typename Class, typename Functor >
+	class PerCpu : public Replicated<Class>, protected Functor {
+	public:
+		/// Virtual destructor for chaining...
+		///
+		virtual ~PerCpu( void ) {}
+
+		/// Return the current CPU's replica, building it if needed.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return shared pointer to CPU's replica.
+		///
+		virtual std::shared_ptr<Class> instantiate( const std::shared_ptr<const Scope> & scope )
+		{
+			return current( scope ).instance;
+		}
+
+		/// Return the current CPU's replica without locking or counting.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return CPU's replica.
+		///
+		virtual Class & local( const std::shared_ptr<const Scope> & scope )
+		{
+			return *current( scope ).instance;
+		}
+
+		/// Call visitor on every replica built so far.
+		///
+		/// @param visitor invoked with each replica.
+		///
+		virtual void visit( const std::function<void( Class & )> & visitor )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			for( std::size_t index = 0; index < count; ++index )
+			{
+				if( slots[ index ].ready.load( std::memory_order_relaxed ) )
+				{
+					visitor( *slots[ index ].instance );
+				}
+			}
+		}
+
+		/// CPUs never exit, so there is nothing to retire.
+		///
+		/// @return 0.
+		///
+		virtual std::size_t retire( const std::function<void( Class & )> & )
+		{
+			return 0;
+		}
+
+		///! Use deduction to forward l- and r-references.
+		///
+		/// @tparam Initializer deduced type, likely Functor.
+		/// @param initializer for Functor instance.
+		///
+		template < typename Initializer >
+		PerCpu( Initializer && initializer )
+		: Functor( std::forward<Initializer>( initializer ) )
+		, count( Replication::cpus() )
+		, slots( new Slot[ count ] )
+		{}
+
+	protected:
+		/// Replica for one CPU--written once, then read-only.
+		///
+		struct Slot {
+			std::atomic<bool> ready{ false };
+			std::shared_ptr<Class> instance;
+		};
+
+		/// Current CPU's slot, building its replica if needed.
+		///
+		/// @param scope used to build a missing replica.
+		/// @return slot holding a replica.
+		///
+		Slot & current( const std::shared_ptr<const Scope> & scope )
+		{
+			Slot & slot = slots[ Replication::cpu() % count ];
+			if( ! slot.ready.load( std::memory_order_acquire ) )
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				if( ! slot.ready.load( std::memory_order_relaxed ) )
+				{
+					slot.instance = Replicated<Class>::build( static_cast<Functor &>( *this ), scope, 0 );
+					slot.ready.store( true, std::memory_order_release );
+				}
+			}
+			return slot;
+		}
+
+		const std::size_t count;	///< Number of slots.
+		std::mutex mutex;	///< Serializes replica construction.
+		std::unique_ptr<Slot[]> slots;	///< Replica per CPU.
+	};
+
+
+	/// Syntatic sugar for creating a PerThread provider.
+	///
+	/// @tparam Class defined by the provider.
+	/// @tparam Functor that creates replicas.
+	/// @param functor l- or r-reference.
+	/// @return reference to provider.
+	///
+	template< typename Class, typename Functor >
+	auto make_per_thread( Functor && functor ) -> Reference< PerThread< Class, typename std::decay<Functor>::type > >
+	{
+		return make_reference< PerThread<Class, typename std::decay<Functor>::type> >( std::forward<Functor>( functor ) );
+	}
+
+
+	/// Syntatic sugar for a PerThread provider of default-constructed replicas.
+	///
+	/// @tparam Class defined by the provider.
+	/// @return reference to provider.
+	///
+	template< typename Class >
+	auto make_per_thread( void ) -> Reference< PerThread< Class, InPlace > >
+	{
+		return make_reference< PerThread<Class, InPlace> >( InPlace{} );
+	}
+
+
+	/// Syntatic sugar for creating a PerCpu provider.
+	///
+	/// @tparam Class defined by the provider.
+	/// @tparam Functor that creates replicas.
+	/// @param functor l- or r-reference.
+	/// @return reference to provider.
+	///
+	template< typename Class, typename Functor >
+	auto make_per_cpu( Functor && functor ) -> Reference< PerCpu< Class, typename std::decay<Functor>::type > >
+	{
+		return make_reference< PerCpu<Class, typename std::decay<Functor>::type> >( std::forward<Functor>( functor ) );
+	}
+
+
+	/// Syntatic sugar for a PerCpu provider of default-constructed replicas.
+	///
+	/// @tparam Class defined by the provider.
+	/// @return reference to provider.
+	///
+	template< typename Class >
+	auto make_per_cpu( void ) -> Reference< PerCpu< Class, InPlace > >
+	{
+		return make_reference< PerCpu<Class, InPlace> >( InPlace{} );
+	}
+
+
+	/// Resolve a replicated provider, e.g. once ahead of a hot loop.
+	///
+	/// Calling local() on the result skips the scope's lock and every
+	/// reference count, unlike get<>().
+	///
+	/// @tparam Class provided.
+	/// @param scope for resolution.
+	/// @return provider or nullptr if Class isn't replicated in scope.
+	///
+	template < typename Class >
+	Reference< Replicated<Class> > get_replicated( const std::shared_ptr<const Scope> & scope )
+	{
+		return dynamic_reference_cast< Replicated<Class> >( scope->resolve( std::type_index{ typeid(Class) } ) );
+	}
+
+
+	/// Resolve a replicated provider, e.g. once ahead of a hot loop.
+	///
+	/// @tparam Class provided.
+	/// @param scope for resolution.
+	/// @return provider or nullptr if Class isn't replicated in scope.
+	///
+	template < typename Class >
+	Reference< Replicated<Class> > get_replicated( const std::shared_ptr<Scope> & scope )
+	{
+		return get_replicated<Class>( std::const_pointer_cast<const Scope>( scope ) );
+	}
+
+
+	/// Visit all replicas of a class if a replicated definition is in scope.
+	///
+	/// @tparam Class to visit.
+	/// @tparam Visitor functor taking Class &--deduced.
+	/// @param scope for resolution.
+	/// @param visitor invoked with each replica.
+	/// @return true if a replicated definition was found.
+	///
+	template < typename Class, typename Visitor >
+	bool visit( const std::shared_ptr<const Scope> & scope, Visitor && visitor )
+	{
+		auto definition = scope->resolve( std::type_index{ typeid(Class) } );
+		auto replicated = dynamic_cast< Replicated<Class> * >( definition.get() );
+		if( replicated )
+		{
+			replicated->visit( std::forward<Visitor>( visitor ) );
+			return true;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+
+	/// Visit all replicas of a class if a replicated definition is in scope.
+	///
+	/// @tparam Class to visit.
+	/// @tparam Visitor functor taking Class &--deduced.
+	/// @param scope for resolution.
+	/// @param visitor invoked with each replica.
+	/// @return true if a replicated definition was found.
+	///
+	template < typename Class, typename Visitor >
+	bool visit( const std::shared_ptr<Scope> & scope, Visitor && visitor )
+	{
+		return visit<Class>( std::const_pointer_cast<const Scope>( scope ), std::forward<Visitor>( visitor ) );
+	}
+}
@@ -2,7 +2,10 @@
 #include <unordered_map>
 #include <memory>
 #include <mutex>
+#include <vector>
 #include <dynaconf/include/Definition.h>
+#include <dynaconf/include/Notifier.h>
+#include <dynaconf/include/Spinlock.h>
 
 namespace dynaconf {
 
@@ -35,21 +38,59 @@ namespace dynaconf {
 		/// @param index to resolve.
 		/// @return Definition or nullptr.
 		///
-		std::shared_ptr<Definition> resolve( const std::type_index & index  ) const;
+		Reference<Definition> resolve( const std::type_index & index  ) const;
 
 		/// Set a definition in this scope--users likely want set().
 		///
 		/// @param definition to set as r-reference.
 		/// @return true on success, false if Class is already defined.
 		///
-		bool define( std::shared_ptr<Definition> && definition );
+		bool define( Reference<Definition> && definition );
 
 		/// Set a definition in this scope--users likely want set().
 		///
 		/// @param definition to set as l-reference.
 		/// @return true on success, false if Class is already defined.
 		///
-		inline bool define( const std::shared_ptr<Definition> & definition ) { return define( std::shared_ptr<Definition>{ definition } ); }
+		inline bool define( const Reference<Definition> & definition ) { return define( Reference<Definition>{ definition } ); }
+
+		/// Set a definition held by a shared_ptr--@see Definition::adopt().
+		///
+		/// @param definition to set.
+		/// @return true on success, false if Class is already defined.
+		///
+		template < typename DefinitionType >
+		bool define( const std::shared_ptr<DefinitionType> & definition ) { return define( Reference<Definition>{ definition } ); }
+
+		/// Set several definitions under a single lock--see Binder.
+		///
+		/// Definitions set are moved out of the batch; those for classes
+		/// already defined are skipped and left in place.
+		///
+		/// @param batch of definitions to set.
+		/// @return number of definitions set.
+		///
+		std::size_t define( std::vector< Reference<Definition> > & batch );
+
+		/// Watch this scope and its ancestors for new definitions.
+		///
+		/// The subscription stays active while the returned pointer is held.
+		/// Changes are batched and delivered on the notifier's thread.
+		///
+		/// @param callback to invoke with changed type_indexes.
+		/// @param notifier delivering changes.
+		/// @return subscription handle.
+		///
+		std::shared_ptr<Subscription> subscribe( Subscription::Callback callback, const std::shared_ptr<Notifier> & notifier = Notifier::Global );
+
+		/// Watch this scope and its ancestors for new definitions of a class.
+		///
+		/// @param index of class to watch.
+		/// @param callback to invoke with changed type_indexes.
+		/// @param notifier delivering changes.
+		/// @return subscription handle.
+		///
+		std::shared_ptr<Subscription> subscribe( const std::type_index & index, Subscription::Callback callback, const std::shared_ptr<Notifier> & notifier = Notifier::Global );
 
 		// Provide default operators.
 		//
@@ -58,9 +99,85 @@ namespace dynaconf {
 		Scope & operator = ( const Scope & ) = default;
 		Scope & operator = ( Scope && ) = default;
 
+		/// Definitions stored inline before spilling to a hash table.
+		///
+		/// Most scopes are small and short-lived; a linear scan of a few
+		/// entries avoids the allocations, hashing, and pointer chasing of
+		/// an unordered_map. Eight cover typical per-request scopes in 160
+		/// bytes; a hit scans only the entries before it.
+		///
+		static constexpr std::size_t Inline = 8;
+
 	protected:
-		mutable std::mutex mutex;	///< Thread-safety for definitions.
-		std::unordered_map< std::type_index, std::shared_ptr<Definition> > definitions;
+		/// Inline definition slot--empty when definition is nullptr.
+		///
+		struct Entry {
+			std::type_index index{ typeid( void ) };
+			Reference<Definition> definition;
+		};
+
+		/// State few scopes need, allocated on first use.
+		///
+		/// Guarded by its own mutex, so the inline lock never covers an
+		/// allocation.
+		///
+		struct Spill {
+			std::mutex mutex;	///< Thread-safety for overflow and subscriptions.
+			std::unordered_map< std::type_index, Reference<Definition> > overflow;	///< Definitions past Inline.
+			std::vector< std::weak_ptr<Subscription> > subscriptions;	///< Watchers of this scope or a descendant.
+		};
+
+		/// Outcome of placing a definition in inline storage.
+		///
+		enum class Placement { Placed, Defined, Full };
+
+		/// Find a definition in inline storage--mutex must be held.
+		///
+		/// @param index to find.
+		/// @return definition or nullptr.
+		///
+		Definition * find( const std::type_index & index ) const;
+
+		/// Add a definition to inline storage--mutex must be held.
+		///
+		/// Once inline storage is full it stays full, so Full also means
+		/// the class isn't defined inline.
+		///
+		/// @param index of defined class.
+		/// @param definition to add; moved from only if Placed.
+		/// @return whether the definition was placed, already defined, or didn't fit.
+		///
+		Placement place( const std::type_index & index, Reference<Definition> & definition );
+
+		/// Add a definition that didn't fit inline--takes the spill's mutex.
+		///
+		/// @param index of defined class.
+		/// @param definition to add; moved from only on success.
+		/// @return true on success, false if already defined.
+		///
+		bool overflow( const std::type_index & index, Reference<Definition> & definition );
+
+		/// Get the spill, allocating it outside of any lock if needed.
+		///
+		/// @return spill of this scope.
+		///
+		Spill & spilled( void );
+
+		/// Post changes to live subscriptions, pruning expired ones.
+		///
+		/// @param changed classes newly defined in this scope.
+		///
+		void publish( const std::vector<std::type_index> & changed );
+
+		/// Register a subscription with this scope and all ancestors.
+		///
+		/// @param subscription to register.
+		///
+		void attach( const std::shared_ptr<Subscription> & subscription );
+
+		mutable Spinlock mutex;	///< Thread-safety for entries and spill--never held to allocate.
+		Entry entries[ Inline ];	///< First definitions, in order of definition.
+		std::unique_ptr<Spill> spill;	///< Overflow and subscriptions, or nullptr.
 		std::shared_ptr<Scope> next;	///< Parent scope or nullptr.
 	};
 
@@ -74,12 +191,14 @@ namespace dynaconf {
 	template < typename Class >
 	std::shared_ptr< Class > get( const std::shared_ptr<const Scope> & scope )
 	{
-		// reinterpret_pointer_cast would be more appropriate, though not available.
+		// Cast the raw pointer: the resolved reference keeps it alive, so
+		// there's no need for a second count.
 		//
-		auto definition = std::dynamic_pointer_cast< Provider<Class> >( scope->resolve( std::type_index{ typeid(Class) } ) );
-		if( definition )
+		auto definition = scope->resolve( std::type_index{ typeid(Class) } );
+		auto provider = dynamic_cast< Provider<Class> * >( definition.get() );
+		if( provider )
 		{
-			return definition->instantiate( scope );
+			return provider->instantiate( scope );
 		}
 		else
 		{
@@ -112,8 +231,38 @@ namespace dynaconf {
 	/// @return true on success, false if Class is already defined in this scope.
 	/// 
 	template < typename DefinitionType >
-	bool set( const std::shared_ptr<Scope> & scope, std::shared_ptr< DefinitionType > definition )
+	bool set( const std::shared_ptr<Scope> & scope, Reference< DefinitionType > definition )
+	{
+		return scope->define( Reference<Definition>{ std::move( definition ) } );
+	}
+
+
+	/// Set a class definition held by a shared_ptr--@see Definition::adopt().
+	///
+	/// @tparam DefinitionType class type of the definition--likely deduced.
+	/// @param scope for definition.
+	/// @param definition to set.
+	/// @return true on success, false if Class is already defined in this scope.
+	///
+	template < typename DefinitionType >
+	bool set( const std::shared_ptr<Scope> & scope, const std::shared_ptr< DefinitionType > & definition )
+	{
+		return scope->define( definition );
+	}
+
+
+	/// Subscribe to new definitions of a class in a scope or its ancestors.
+	///
+	/// @tparam Class to watch.
+	/// @tparam Callback functor taking the changed type_indexes--deduced.
+	/// @param scope to watch.
+	/// @param callback to invoke with batched changes.
+	/// @param notifier delivering changes.
+	/// @return subscription handle; dropping it unsubscribes.
+	///
+	template < typename Class, typename Callback >
+	std::shared_ptr<Subscription> subscribe( const std::shared_ptr<Scope> & scope, Callback && callback, const std::shared_ptr<Notifier> & notifier = Notifier::Global )
 	{
-		return scope->define( std::static_pointer_cast<Definition>( definition ) );
+		return scope->subscribe( std::type_index{ typeid(Class) }, std::forward<Callback>( callback ), notifier );
 	}
 }
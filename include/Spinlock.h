@@ -0,0 +1,51 @@
+#pragma once
+#include <atomic>
+#include <thread>
+
+namespace dynaconf {
+
+	/// Single-byte lock for short critical sections.
+	///
+	/// Satisfies Lockable, so it works with std::unique_lock. Waiters spin
+	/// briefly, then yield, so a preempted holder isn't starved of its CPU.
+	/// Use std::mutex where sections block or run long.
+	///
+	class Spinlock {
+	public:
+		Spinlock( void )
+		: held( false )
+		{}
+
+		Spinlock( const Spinlock & ) = delete;
+		Spinlock & operator = ( const Spinlock & ) = delete;
+
+		void lock( void )
+		{
+			while( held.exchange( true, std::memory_order_acquire ) )
+			{
+				for( unsigned int spins = 0; held.load( std::memory_order_relaxed ); ++spins )
+				{
+					if( spins >= Spins )
+					{
+						std::this_thread::yield();
+					}
+				}
+			}
+		}
+
+		bool try_lock( void )
+		{
+			return ! held.load( std::memory_order_relaxed ) && ! held.exchange( true, std::memory_order_acquire );
+		}
+
+		void unlock( void )
+		{
+			held.store( false, std::memory_order_release );
+		}
+
+	protected:
+		static constexpr unsigned int Spins = 64;	///< Polls before yielding.
+
+		std::atomic<bool> held;	///< Locked by some thread.
+	};
+}
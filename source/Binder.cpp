@@ -0,0 +1,219 @@
+#include <dynaconf/include/Binder.h>
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace dynaconf {
+
+	/// Order entries against a name that need not be null-terminated.
+	///
+	static int compare( const std::string & entry, const char * name, std::size_t length )
+	{
+		return entry.compare( 0, std::string::npos, name, length );
+	}
+
+	/// Create a binder resolving against a set of options.
+	///
+	/// @param source options to resolve flag values in.
+	///
+	Binder::Binder( const std::shared_ptr<Options> & source )
+	: options( source )
+	{}
+
+	/// Bind a flag name (without leading dashes) to a class.
+	///
+	/// @param index of class selected by the flag.
+	/// @param flag name.
+	/// @return false if the flag or its variable name is already bound.
+	///
+	bool Binder::bind( const std::type_index & index, const std::string & flag )
+	{
+		std::string variable{ flag };
+		for( auto & character : variable )
+		{
+			character = character == '-' ? '_' : static_cast<char>( std::toupper( static_cast<unsigned char>( character ) ) );
+		}
+
+		// Distinct flags may normalize to the same variable, e.g. log-level
+		// and log_level.
+		//
+		if( find( flags, flag.data(), flag.size() ) || find( variables, variable.data(), variable.size() ) )
+		{
+			return false;
+		}
+
+		const Entry byFlag{ flag, bindings.size() };
+		const Entry byVariable{ variable, bindings.size() };
+		const auto order = []( const Entry & left, const Entry & right ) { return left.name < right.name; };
+
+		bindings.push_back( index );
+		flags.insert( std::upper_bound( flags.begin(), flags.end(), byFlag, order ), byFlag );
+		variables.insert( std::upper_bound( variables.begin(), variables.end(), byVariable, order ), byVariable );
+		return true;
+	}
+
+	/// Find an entry by name.
+	///
+	/// @param entries to search.
+	/// @param name start of name.
+	/// @param length of name.
+	/// @return entry or nullptr.
+	///
+	const Binder::Entry * Binder::find( const std::vector<Entry> & entries, const char * name, std::size_t length )
+	{
+		auto entry = std::lower_bound( entries.begin(), entries.end(), name, [length]( const Entry & left, const char * right )
+		{
+			return compare( left.name, right, length ) < 0;
+		});
+		if( entry != entries.end() && compare( entry->name, name, length ) == 0 )
+		{
+			return &*entry;
+		}
+		return nullptr;
+	}
+
+	/// Apply command-line flags to a scope in one batch.
+	///
+	/// @param scope to define selected options in.
+	/// @param argc count of arguments.
+	/// @param argv arguments as passed to main.
+	/// @return applied count and any rejected arguments.
+	///
+	Binder::Result Binder::apply( const std::shared_ptr<Scope> & scope, int argc, const char * const * argv ) const
+	{
+		return apply( scope, argc, argv, nullptr, std::string{} );
+	}
+
+	/// Apply environment variables, then command-line flags, in one batch.
+	///
+	/// @param scope to define selected options in.
+	/// @param argc count of arguments.
+	/// @param argv arguments as passed to main.
+	/// @param environment null-terminated NAME=VALUE entries, e.g. environ.
+	/// @param prefix required on variable names; unknown prefixed variables are reported.
+	/// @return applied count and any rejected arguments.
+	///
+	Binder::Result Binder::apply( const std::shared_ptr<Scope> & scope, int argc, const char * const * argv, const char * const * environment, const std::string & prefix ) const
+	{
+		Result result;
+
+		// Selected value per binding: environment first, so that the command
+		// line may override it.
+		//
+		struct Selection {
+			const char * argument = nullptr;	///< Whole argument, for reporting.
+			const char * value = nullptr;	///< Option key.
+			bool fromCommandLine = false;
+		};
+		std::vector<Selection> selections( bindings.size() );
+
+		for( auto entry = environment; entry && *entry; ++entry )
+		{
+			const char * name = *entry;
+			if( std::strncmp( name, prefix.data(), prefix.size() ) != 0 )
+			{
+				continue;
+			}
+			name += prefix.size();
+			const char * equals = std::strchr( name, '=' );
+			if( ! equals )
+			{
+				continue;
+			}
+
+			auto variable = find( variables, name, static_cast<std::size_t>( equals - name ) );
+			if( variable )
+			{
+				auto & selection = selections[ variable->binding ];
+				selection.argument = *entry;
+				selection.value = equals + 1;
+			}
+			else if( ! prefix.empty() )
+			{
+				result.unknown.emplace_back( *entry );
+			}
+		}
+
+		for( int index = 1; index < argc; ++index )
+		{
+			const char * argument = argv[ index ];
+			if( std::strncmp( argument, "--", 2 ) != 0 )
+			{
+				continue;
+			}
+			if( argument[ 2 ] == '\0' )
+			{
+				break;
+			}
+
+			const char * name = argument + 2;
+			const char * equals = std::strchr( name, '=' );
+			const std::size_t length = equals ? static_cast<std::size_t>( equals - name ) : std::strlen( name );
+
+			auto flag = find( flags, name, length );
+			if( ! flag )
+			{
+				result.unknown.emplace_back( argument );
+				continue;
+			}
+
+			auto & selection = selections[ flag->binding ];
+			if( selection.fromCommandLine )
+			{
+				result.duplicate.emplace_back( argument );
+				continue;
+			}
+			selection.argument = argument;
+			selection.value = equals ? equals + 1 : "";
+			selection.fromCommandLine = true;
+		}
+
+		// Resolve everything under one Options lock, then define under one
+		// Scope lock.
+		//
+		std::vector< std::pair<std::type_index, const char *> > requests;
+		std::vector<const char *> arguments;
+		for( std::size_t binding = 0; binding < bindings.size(); ++binding )
+		{
+			if( selections[ binding ].value )
+			{
+				requests.emplace_back( bindings[ binding ], selections[ binding ].value );
+				arguments.push_back( selections[ binding ].argument );
+			}
+		}
+		if( requests.empty() )
+		{
+			return result;
+		}
+
+		auto resolved = options->resolve( requests );
+		std::vector< Reference<Definition> > batch;
+		std::vector<const char *> batched;
+		batch.reserve( resolved.size() );
+		batched.reserve( resolved.size() );
+		for( std::size_t request = 0; request < resolved.size(); ++request )
+		{
+			if( resolved[ request ] )
+			{
+				batch.push_back( std::move( resolved[ request ] ) );
+				batched.push_back( arguments[ request ] );
+			}
+			else
+			{
+				result.unresolved.emplace_back( arguments[ request ] );
+			}
+		}
+
+		// Definitions left in the batch were skipped by the scope.
+		//
+		result.applied = scope->define( batch );
+		for( std::size_t entry = 0; entry < batch.size(); ++entry )
+		{
+			if( batch[ entry ] )
+			{
+				result.defined.emplace_back( batched[ entry ] );
+			}
+		}
+		return result;
+	}
+}
@@ -0,0 +1,66 @@
+#include <dynaconf/include/Definition.h>
+#include <mutex>
+#include <unordered_map>
+
+namespace dynaconf {
+
+	/// Registry of shared_ptr owners of adopted definitions.
+	///
+	struct Owners {
+		std::mutex mutex;	///< Guards owners and the Shared flag.
+		std::unordered_map< const Definition *, std::shared_ptr<const void> > owners;	///< Owner by definition.
+
+		/// Access the registry, which is never destroyed.
+		///
+		/// Static Options release adopted definitions during exit, possibly
+		/// after a function-local static registry would have been destroyed.
+		///
+		static Owners & instance( void )
+		{
+			static Owners & registry = *new Owners;
+			return registry;
+		}
+	};
+
+	/// Add a reference to a definition owned by a shared_ptr.
+	///
+	/// The first adoption registers the owner and flags the count so that
+	/// release() never deletes the definition itself.
+	///
+	/// @param owner to keep alive until the last reference is dropped.
+	///
+	void Definition::adopt( std::shared_ptr<const void> owner ) const
+	{
+		auto & registry = Owners::instance();
+		std::unique_lock<std::mutex> lock( registry.mutex );
+		if( ! ( references.load( std::memory_order_relaxed ) & Shared ) )
+		{
+			registry.owners[ this ] = std::move( owner );
+			references.fetch_or( Shared, std::memory_order_relaxed );
+		}
+		references.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	/// Drop the registered owner once no references remain.
+	///
+	/// A concurrent adopt() may have added a reference since release(), in
+	/// which case the owner stays registered.
+	///
+	void Definition::disown( void ) const
+	{
+		std::shared_ptr<const void> owner;
+		{
+			auto & registry = Owners::instance();
+			std::unique_lock<std::mutex> lock( registry.mutex );
+			if( references.load( std::memory_order_acquire ) != Shared )
+			{
+				return;
+			}
+			references.store( 0, std::memory_order_relaxed );
+			auto entry = registry.owners.find( this );
+			owner = std::move( entry->second );
+			registry.owners.erase( entry );
+		}
+		// Dropping the owner may delete this definition.
+	}
+}
@@ -0,0 +1,184 @@
+#include <dynaconf/include/Notifier.h>
+#include <algorithm>
+
+namespace dynaconf {
+
+	/// Create a subscription for changes to any class.
+	///
+	/// @param receiver to invoke with batched changes.
+	/// @param dispatcher delivering the changes.
+	///
+	Subscription::Subscription( Callback && receiver, const std::shared_ptr<Notifier> & dispatcher )
+	: filtered( false )
+	, filter( typeid( void ) )
+	, callback( std::move( receiver ) )
+	, notifier( dispatcher )
+	, scheduled( false )
+	{}
+
+	/// Create a subscription for changes to a single class.
+	///
+	/// @param index of class to watch.
+	/// @param receiver to invoke with batched changes.
+	/// @param dispatcher delivering the changes.
+	///
+	Subscription::Subscription( const std::type_index & index, Callback && receiver, const std::shared_ptr<Notifier> & dispatcher )
+	: filtered( true )
+	, filter( index )
+	, callback( std::move( receiver ) )
+	, notifier( dispatcher )
+	, scheduled( false )
+	{}
+
+	/// Record a change and schedule delivery if not already pending.
+	///
+	/// Repeated changes to a class coalesce into one entry per batch. Once
+	/// the notifier is gone, pending changes are dropped.
+	///
+	/// @param index of changed class.
+	///
+	void Subscription::post( const std::type_index & index )
+	{
+		auto dispatcher = notifier.lock();
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			if( ! dispatcher )
+			{
+				pending.clear();
+				scheduled = false;
+				return;
+			}
+			if( std::find( pending.begin(), pending.end(), index ) == pending.end() )
+			{
+				pending.push_back( index );
+			}
+			if( scheduled )
+			{
+				return;
+			}
+			scheduled = true;
+		}
+		dispatcher->schedule( shared_from_this() );
+	}
+
+	/// Hand pending changes to the callback--called by the notifier.
+	///
+	void Subscription::deliver( void )
+	{
+		std::vector<std::type_index> batch;
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			batch.swap( pending );
+			scheduled = false;
+		}
+		if( ! batch.empty() )
+		{
+			callback( batch );
+		}
+	}
+
+	Notifier::Notifier( void )
+	: queue( std::make_shared<Queue>() )
+	{}
+
+	/// Stops and joins the worker--pending deliveries are discarded.
+	///
+	/// If destroyed by one of its own callbacks the worker is detached
+	/// instead, and exits once that delivery returns.
+	///
+	Notifier::~Notifier( void )
+	{
+		{
+			std::unique_lock<std::mutex> lock( queue->mutex );
+			queue->stopping = true;
+		}
+		queue->wake.notify_all();
+		queue->idle.notify_all();
+		if( ! worker.joinable() )
+		{
+			return;
+		}
+		if( worker.get_id() == std::this_thread::get_id() )
+		{
+			worker.detach();
+		}
+		else
+		{
+			worker.join();
+		}
+	}
+
+	/// Queue a subscription for delivery.
+	///
+	/// @param subscription with pending changes.
+	///
+	void Notifier::schedule( std::weak_ptr<Subscription> && subscription )
+	{
+		{
+			std::unique_lock<std::mutex> lock( queue->mutex );
+			queue->pending.push_back( std::move( subscription ) );
+			if( ! worker.joinable() )
+			{
+				worker = std::thread( &Notifier::run, queue );
+			}
+		}
+		queue->wake.notify_one();
+	}
+
+	/// Block until every queued delivery has been made.
+	///
+	void Notifier::drain( void )
+	{
+		auto & state = *queue;
+		std::unique_lock<std::mutex> lock( state.mutex );
+		state.idle.wait( lock, [&state]{ return ( state.pending.empty() && ! state.busy ) || state.stopping; } );
+	}
+
+	/// Worker loop: deliver queued subscriptions until stopped.
+	///
+	/// @param queue shared with the notifier.
+	///
+	void Notifier::run( std::shared_ptr<Queue> queue )
+	{
+		auto & state = *queue;
+		std::unique_lock<std::mutex> lock( state.mutex );
+		while( true )
+		{
+			state.wake.wait( lock, [&state]{ return ! state.pending.empty() || state.stopping; } );
+			if( state.stopping )
+			{
+				break;
+			}
+
+			// Deliver everything queued so far as one batch of work.
+			//
+			std::deque< std::weak_ptr<Subscription> > batch;
+			batch.swap( state.pending );
+			state.busy = true;
+			lock.unlock();
+
+			for( auto & entry : batch )
+			{
+				auto subscription = entry.lock();
+				if( subscription )
+				{
+					subscription->deliver();
+				}
+			}
+
+			lock.lock();
+			state.busy = false;
+			if( state.pending.empty() )
+			{
+				state.idle.notify_all();
+			}
+		}
+		state.idle.notify_all();
+	}
+
+	/// Default global notifier
+	///
+	static Notifier globals;
+
+	const std::shared_ptr<Notifier> Notifier::Global{ &globals, [](Notifier*){} };
+}
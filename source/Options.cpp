@@ -1,25 +1,58 @@
 #include <dynaconf/include/Options.h>
+#include <dlfcn.h>
 
 namespace dynaconf {
 
+	/// Create a set of options, optionally backed by export tables.
+	///
+	/// @param link if true, DYNACONF_EXPORT tables are indexed on use.
+	///
+	Options::Options( bool link )
+	: linked( link )
+	, indexed( nullptr )
+	{}
+
 	/// Define an option for a class.
 	///
+	/// Explicit definitions take precedence over DYNACONF_EXPORT records
+	/// for the same class and key, whichever is indexed first. Export
+	/// tables are not indexed here, so static-init callers build none.
+	///
 	/// @param defintion to set.
 	/// @param key identifying that definition.
 	/// @return boolean indication of success.
 	///
-	bool Options::define( std::shared_ptr<Definition> && definition, const std::string & key )
+	bool Options::define( Reference<Definition> && definition, const std::string & key )
 	{
 		std::unique_lock<std::mutex> lock( mutex );
+		return insert( std::move( definition ), key, false );
+	}
+
+	/// Insert a definition--mutex must be held.
+	///
+	/// @param definition to set.
+	/// @param key identifying that definition.
+	/// @param exported if from an export record, which never replaces.
+	/// @return boolean indication of success.
+	///
+	bool Options::insert( Reference<Definition> && definition, const std::string & key, bool exported ) const
+	{
 		auto index = definition->index();
 
 		// attempt update cluster
 		//
-		auto result = clusters[ index ].definitions.emplace( std::piecewise_construct,
-			std::forward_as_tuple( key ),
-			std::forward_as_tuple( std::move( definition ) ) );
-
-		return result.second;
+		auto result = clusters[ index ].definitions.emplace( key, Entry{ Reference<Definition>{ nullptr }, exported } );
+		if( result.second )
+		{
+			result.first->second.definition = std::move( definition );
+			return true;
+		}
+		else if( result.first->second.exported && ! exported )
+		{
+			result.first->second = Entry{ std::move( definition ), false };
+			return true;
+		}
+		return false;
 	}
 
 	/// Resolve an option for a class.
@@ -28,24 +61,118 @@ namespace dynaconf {
 	/// @param key identifying a definition.
 	/// @return pointer to definition or nullptr.
 	///
-	std::shared_ptr<Definition> Options::resolve( const std::type_index & index, const std::string & key ) const
+	Reference<Definition> Options::resolve( const std::type_index & index, const std::string & key ) const
 	{
 		std::unique_lock<std::mutex> lock( mutex );
+		absorb();
 		auto cluster = clusters.find( index );
 		if( cluster != clusters.end() )
 		{
 			auto result = cluster->second.definitions.find( key );
 			if( result != cluster->second.definitions.end() )
 			{
-				return result->second;
+				return result->second.definition;
 			}
 		}
-		return std::shared_ptr<Definition>{ nullptr };
+		return Reference<Definition>{ nullptr };
 	}
 
+	/// Resolve several options under a single lock--see Binder.
+	///
+	/// @param requests of type_index and null-terminated key pairs.
+	/// @return definition or nullptr for each request, in order.
+	///
+	std::vector< Reference<Definition> > Options::resolve( const std::vector< std::pair<std::type_index, const char *> > & requests ) const
+	{
+		std::vector< Reference<Definition> > result;
+		result.reserve( requests.size() );
+
+		// Clusters are keyed by std::string; reuse one buffer so lookups
+		// only allocate when a key outgrows every key before it.
+		//
+		std::string key;
+
+		std::unique_lock<std::mutex> lock( mutex );
+		absorb();
+		for( const auto & request : requests )
+		{
+			Reference<Definition> definition{ nullptr };
+			auto cluster = clusters.find( request.first );
+			if( cluster != clusters.end() )
+			{
+				key.assign( request.second );
+				auto entry = cluster->second.definitions.find( key );
+				if( entry != cluster->second.definitions.end() )
+				{
+					definition = entry->second.definition;
+				}
+			}
+			result.push_back( std::move( definition ) );
+		}
+		return result;
+	}
+
+	/// Publish a module's table for lazy indexing--lock-free.
+	///
+	/// Modules with exports are made resident: options keep both their
+	/// definitions and the table itself, so dlclose() must not unmap them.
+	///
+	/// @param table to publish.
+	/// @return true.
+	///
+	bool Options::enlist( Table * table )
+	{
+		Dl_info module;
+		if( table->begin != table->end && dladdr( table, &module ) && module.dli_fname )
+		{
+			// Only takes a reference if the module is already loaded.
+			//
+			dlopen( module.dli_fname, RTLD_LAZY | RTLD_NOLOAD | RTLD_NODELETE );
+		}
+
+		table->next = Tables.load( std::memory_order_relaxed );
+		while( ! Tables.compare_exchange_weak( table->next, table, std::memory_order_release, std::memory_order_relaxed ) )
+		{}
+		return true;
+	}
+
+	/// Index tables enlisted since the last call--mutex must be held.
+	///
+	void Options::absorb( void ) const
+	{
+		if( ! linked )
+		{
+			return;
+		}
+		Table * head = Tables.load( std::memory_order_acquire );
+		if( head == indexed )
+		{
+			return;
+		}
+
+		// Newest tables are first; index oldest first so earlier modules
+		// win key collisions, as with static-init exports.
+		//
+		std::vector<Table *> pending;
+		for( Table * table = head; table != indexed; table = table->next )
+		{
+			pending.push_back( table );
+		}
+		for( auto table = pending.rbegin(); table != pending.rend(); ++table )
+		{
+			for( const Record * record = ( *table )->begin; record != ( *table )->end; ++record )
+			{
+				insert( record->make(), record->key, true );
+			}
+		}
+		indexed = head;
+	}
+
+	std::atomic<Options::Table *> Options::Tables{ nullptr };
+
 	/// Default global option set
 	///
-	static Options globals;
+	static Options globals{ true };
 
 	const std::shared_ptr<Options> Options::Global{ &globals, [](Options*){} };
 }
@@ -0,0 +1,66 @@
+#include <dynaconf/include/Replicated.h>
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace dynaconf {
+
+	/// Allocate a process-unique identity for a provider.
+	///
+	/// @return identity never reused by another provider.
+	///
+	std::uint64_t Replication::identify( void )
+	{
+		static std::atomic<std::uint64_t> counter{ 0 };
+		return counter.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	/// Calling thread's replicas keyed by provider identity.
+	///
+	/// @return thread-local table.
+	///
+	std::unordered_map< std::uint64_t, Replication::Cached > & Replication::local( void )
+	{
+		static thread_local std::unordered_map< std::uint64_t, Cached > table;
+		return table;
+	}
+
+	/// Token of the calling thread, expiring when the thread exits.
+	///
+	/// @return weak token.
+	///
+	std::weak_ptr<void> Replication::thread( void )
+	{
+		static thread_local std::shared_ptr<char> token{ new char{} };
+		return token;
+	}
+
+	/// Index of the CPU running the calling thread.
+	///
+	/// @return CPU index, or 0 where unsupported.
+	///
+	unsigned int Replication::cpu( void )
+	{
+#ifdef __linux__
+		const int result = sched_getcpu();
+		return result < 0 ? 0u : static_cast<unsigned int>( result );
+#else
+		return 0u;
+#endif
+	}
+
+	/// Number of configured CPUs.
+	///
+	/// @return upper bound on cpu() + 1.
+	///
+	unsigned int Replication::cpus( void )
+	{
+#ifdef __linux__
+		const long result = sysconf( _SC_NPROCESSORS_CONF );
+		return result < 1 ? 1u : static_cast<unsigned int>( result );
+#else
+		return 1u;
+#endif
+	}
+}
@@ -1,4 +1,5 @@
 #include <dynaconf/include/Scope.h>
+#include <algorithm>
 
 namespace dynaconf {
 
@@ -10,6 +11,8 @@ namespace dynaconf {
 	: next( parent )
 	{}
 
+	constexpr std::size_t Scope::Inline;
+
 	/// Resolve the type_index to a definition--users likely want get().
 	///
 	/// Applies recursive scope resolution.
@@ -17,19 +20,123 @@ namespace dynaconf {
 	/// @param index to resolve.
 	/// @return Definition or nullptr.
 	///
-	std::shared_ptr<Definition> Scope::resolve( const std::type_index & index ) const
+	Reference<Definition> Scope::resolve( const std::type_index & index ) const
+	{
+		Spill * spilled;
+		{
+			std::unique_lock<Spinlock> lock( mutex );
+			auto result = find( index );
+			if( result )
+			{
+				return Reference<Definition>{ result };
+			}
+			spilled = spill.get();
+		}
+
+		// The spill lives as long as the scope once set.
+		//
+		if( spilled )
+		{
+			std::unique_lock<std::mutex> lock( spilled->mutex );
+			auto result = spilled->overflow.find( index );
+			if( result != spilled->overflow.end() )
+			{
+				return result->second;
+			}
+		}
+
+		// Parent is fixed at construction; no need to hold our lock.
+		//
+		return next ? next->resolve( index ) : Reference<Definition>( nullptr );
+	}
+
+	/// Find a definition in inline storage--mutex must be held.
+	///
+	/// @param index to find.
+	/// @return definition or nullptr.
+	///
+	Definition * Scope::find( const std::type_index & index ) const
+	{
+		for( std::size_t slot = 0; slot < Inline && entries[ slot ].definition; ++slot )
+		{
+			if( entries[ slot ].index == index )
+			{
+				return entries[ slot ].definition.get();
+			}
+		}
+		return nullptr;
+	}
+
+	/// Add a definition to inline storage--mutex must be held.
+	///
+	/// @param index of defined class.
+	/// @param definition to add; moved from only if Placed.
+	/// @return whether the definition was placed, already defined, or didn't fit.
+	///
+	Scope::Placement Scope::place( const std::type_index & index, Reference<Definition> & definition )
+	{
+		for( std::size_t slot = 0; slot < Inline; ++slot )
+		{
+			if( ! entries[ slot ].definition )
+			{
+				entries[ slot ].index = index;
+				entries[ slot ].definition = std::move( definition );
+				return Placement::Placed;
+			}
+			if( entries[ slot ].index == index )
+			{
+				return Placement::Defined;
+			}
+		}
+		return Placement::Full;
+	}
+
+	/// Add a definition that didn't fit inline--takes the spill's mutex.
+	///
+	/// @param index of defined class.
+	/// @param definition to add; moved from only on success.
+	/// @return true on success, false if already defined.
+	///
+	bool Scope::overflow( const std::type_index & index, Reference<Definition> & definition )
 	{
-		std::unique_lock<std::mutex> lock( mutex );
+		auto & spilled = this->spilled();
+		std::unique_lock<std::mutex> lock( spilled.mutex );
 
-		const auto result = definitions.find( index );
-		if( result == definitions.end() )
+		// Checked apart from emplace, which may move from definition even
+		// when the class is already defined.
+		//
+		if( spilled.overflow.find( index ) != spilled.overflow.end() )
 		{
-			return next ? next->resolve( index ) : std::shared_ptr<Definition>( nullptr );
+			return false;
 		}
-		else
+		spilled.overflow.emplace( index, std::move( definition ) );
+		return true;
+	}
+
+	/// Get the spill, allocating it outside of any lock if needed.
+	///
+	/// @return spill of this scope.
+	///
+	Scope::Spill & Scope::spilled( void )
+	{
 		{
-			return result->second;
+			std::unique_lock<Spinlock> lock( mutex );
+			if( spill )
+			{
+				return *spill;
+			}
 		}
+
+		// A racing thread may install its own first; ours is then freed
+		// after the lock is released.
+		//
+		std::unique_ptr<Spill> fresh{ new Spill{} };
+		std::unique_lock<Spinlock> lock( mutex );
+		if( ! spill )
+		{
+			spill = std::move( fresh );
+		}
+		return *spill;
 	}
 
 	/// Set a definition in this scope--users likely want set().
@@ -37,14 +144,175 @@ namespace dynaconf {
 	/// @param definition to set as r-reference.
 	/// @return true on success, false if Class is already defined.
 	///
-	bool Scope::define( std::shared_ptr<Definition> && definition )
+	bool Scope::define( Reference<Definition> && definition )
 	{
-		std::unique_lock<std::mutex> lock( mutex );
+		const auto index = definition->index();
+		Placement placement;
+		bool watched;
+		{
+			std::unique_lock<Spinlock> lock( mutex );
+			placement = place( index, definition );
+			watched = spill != nullptr;
+		}
+
+		if( placement == Placement::Defined || ( placement == Placement::Full && ! overflow( index, definition ) ) )
+		{
+			return false;
+		}
 
-		auto result = definitions.emplace( std::piecewise_construct,
-			std::forward_as_tuple( definition->index() ),
-			std::forward_as_tuple( std::move( definition ) ) );
+		// Only a spill holds subscriptions; post outside of every lock so
+		// delivery never contends with resolution.
+		//
+		if( watched || placement == Placement::Full )
+		{
+			publish( std::vector<std::type_index>{ index } );
+		}
+		return true;
+	}
 
-		return result.second;
+	/// Set several definitions in this scope under a single lock.
+	///
+	/// Definitions that don't fit inline are then set under the spill's
+	/// lock. Definitions set are moved out of the batch; those for
+	/// classes already defined are skipped and left in place.
+	///
+	/// @param batch of definitions to set.
+	/// @return number of definitions set.
+	///
+	std::size_t Scope::define( std::vector< Reference<Definition> > & batch )
+	{
+		std::vector<std::type_index> changed;
+		std::vector< Reference<Definition> * > full;
+		changed.reserve( batch.size() );
+		full.reserve( batch.size() );
+
+		bool watched;
+		{
+			std::unique_lock<Spinlock> lock( mutex );
+			for( auto & definition : batch )
+			{
+				const auto index = definition->index();
+				switch( place( index, definition ) )
+				{
+				case Placement::Placed:
+					changed.push_back( index );
+					break;
+				case Placement::Full:
+					full.push_back( &definition );
+					break;
+				case Placement::Defined:
+					break;
+				}
+			}
+			watched = spill != nullptr;
+		}
+
+		for( auto definition : full )
+		{
+			const auto index = ( *definition )->index();
+			if( overflow( index, *definition ) )
+			{
+				changed.push_back( index );
+			}
+		}
+
+		if( ! changed.empty() && ( watched || ! full.empty() ) )
+		{
+			publish( changed );
+		}
+		return changed.size();
+	}
+
+	/// Watch this scope and its ancestors for new definitions.
+	///
+	/// @param callback to invoke with changed type_indexes.
+	/// @param notifier delivering changes.
+	/// @return subscription handle.
+	///
+	std::shared_ptr<Subscription> Scope::subscribe( Subscription::Callback callback, const std::shared_ptr<Notifier> & notifier )
+	{
+		auto subscription = std::make_shared<Subscription>( std::move( callback ), notifier );
+		attach( subscription );
+		return subscription;
+	}
+
+	/// Watch this scope and its ancestors for new definitions of a class.
+	///
+	/// @param index of class to watch.
+	/// @param callback to invoke with changed type_indexes.
+	/// @param notifier delivering changes.
+	/// @return subscription handle.
+	///
+	std::shared_ptr<Subscription> Scope::subscribe( const std::type_index & index, Subscription::Callback callback, const std::shared_ptr<Notifier> & notifier )
+	{
+		auto subscription = std::make_shared<Subscription>( index, std::move( callback ), notifier );
+		attach( subscription );
+		return subscription;
+	}
+
+	/// Post changes to live subscriptions, pruning expired ones.
+	///
+	/// @param changed classes newly defined in this scope.
+	///
+	void Scope::publish( const std::vector<std::type_index> & changed )
+	{
+		auto & spilled = this->spilled();
+		std::vector< std::shared_ptr<Subscription> > live;
+		{
+			std::unique_lock<std::mutex> lock( spilled.mutex );
+			auto & subscriptions = spilled.subscriptions;
+			auto iter = subscriptions.begin();
+			while( iter != subscriptions.end() )
+			{
+				auto subscription = iter->lock();
+				if( subscription )
+				{
+					live.push_back( std::move( subscription ) );
+					++iter;
+				}
+				else
+				{
+					iter = subscriptions.erase( iter );
+				}
+			}
+		}
+
+		for( auto & watcher : live )
+		{
+			for( const auto & index : changed )
+			{
+				if( watcher->matches( index ) )
+				{
+					watcher->post( index );
+				}
+			}
+		}
+	}
+
+	/// Register a subscription with this scope and all ancestors.
+	///
+	/// @param subscription to register.
+	///
+	void Scope::attach( const std::shared_ptr<Subscription> & subscription )
+	{
+		for( Scope * scope = this; scope; scope = scope->next.get() )
+		{
+			auto & spilled = scope->spilled();
+			std::unique_lock<std::mutex> lock( spilled.mutex );
+
+			// Ancestors are rarely redefined, so define() alone won't prune
+			// them. Sweep expired entries whenever the vector would grow,
+			// which bounds it to twice the live count at O(1) amortized.
+			//
+			auto & list = spilled.subscriptions;
+			if( list.size() == list.capacity() )
+			{
+				list.erase( std::remove_if( list.begin(), list.end(), []( const std::weak_ptr<Subscription> & entry )
+				{
+					return entry.expired();
+				}), list.end() );
+			}
+			list.emplace_back( subscription );
+		}
 	}
 }
@@ -0,0 +1,99 @@
+#include <catch.hpp>
+#include <dynaconf/include/Binder.h>
+#include <dynaconf/include/NamedType.h>
+#include "Numbered.h"
+
+using Connection = dynaconf::NamedType<std::string, struct ConnectionParameter >;
+using Level = dynaconf::NamedType<int, struct LevelParameter >;
+
+SCENARIO( "binders should apply argv and environment options in one batch" )
+{
+	GIVEN( "options, a scope, and a binder with bound flags" )
+	{
+		auto options = std::make_shared<dynaconf::Options>();
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		dynaconf::set( options, "ZMQ", dynaconf::make_singleton<Connection>( std::make_shared<Connection>( "zmq" ) ) );
+		dynaconf::set( options, "TCP", dynaconf::make_singleton<Connection>( std::make_shared<Connection>( "tcp" ) ) );
+		dynaconf::set( options, "high", dynaconf::make_singleton<Level>( std::make_shared<Level>( 10 ) ) );
+		dynaconf::set( options, "", dynaconf::make_singleton<Level>( std::make_shared<Level>( 1 ) ) );
+
+		dynaconf::Binder binder{ options };
+		REQUIRE( dynaconf::bind<Connection>( binder, "connection" ) );
+		REQUIRE( dynaconf::bind<Level>( binder, "log-level" ) );
+		REQUIRE_FALSE( dynaconf::bind<Level>( binder, "log-level" ) );
+		REQUIRE_FALSE( dynaconf::bind<Connection>( binder, "log_level" ) );
+		REQUIRE_FALSE( dynaconf::bind<Connection>( binder, "LOG-LEVEL" ) );
+
+		THEN( "matching flags should be applied" )
+		{
+			const char * argv[] = { "program", "positional", "--connection=ZMQ", "--log-level=high" };
+			auto result = binder.apply( scope, 4, argv );
+
+			REQUIRE( result );
+			REQUIRE( result.applied == 2 );
+			REQUIRE( dynaconf::get<Connection>( scope )->value() == "zmq" );
+			REQUIRE( dynaconf::get<Level>( scope )->value() == 10 );
+		}
+
+		THEN( "bare flags should select the empty option" )
+		{
+			const char * argv[] = { "program", "--log-level" };
+			REQUIRE( binder.apply( scope, 2, argv ).applied == 1 );
+			REQUIRE( dynaconf::get<Level>( scope )->value() == 1 );
+		}
+
+		THEN( "unknown, duplicate, and unresolved flags should be reported" )
+		{
+			const char * argv[] = { "program", "--verbose", "--connection=TCP", "--connection=ZMQ", "--log-level=bogus", "--", "--ignored" };
+			auto result = binder.apply( scope, 7, argv );
+
+			REQUIRE_FALSE( result );
+			REQUIRE( result.applied == 1 );
+			REQUIRE( result.unknown == std::vector<std::string>{ "--verbose" } );
+			REQUIRE( result.duplicate == std::vector<std::string>{ "--connection=ZMQ" } );
+			REQUIRE( result.unresolved == std::vector<std::string>{ "--log-level=bogus" } );
+			REQUIRE( dynaconf::get<Connection>( scope )->value() == "tcp" );
+			REQUIRE( dynaconf::get<Level>( scope ) == nullptr );
+		}
+
+		THEN( "flags for classes the scope already defines should be reported" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<Level>( std::make_shared<Level>( 5 ) ) ) );
+			const char * argv[] = { "program", "--connection=ZMQ", "--log-level=high" };
+			auto result = binder.apply( scope, 3, argv );
+
+			REQUIRE_FALSE( result );
+			REQUIRE( result.applied == 1 );
+			REQUIRE( result.defined == std::vector<std::string>{ "--log-level=high" } );
+			REQUIRE( dynaconf::get<Level>( scope )->value() == 5 );
+		}
+
+		THEN( "flags for classes defined past inline storage should be reported" )
+		{
+			std::vector< dynaconf::Reference<dynaconf::Definition> > fill;
+			Numbered< dynaconf::Scope::Inline >::define( fill );
+			REQUIRE( scope->define( fill ) == dynaconf::Scope::Inline );
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<Level>( std::make_shared<Level>( 5 ) ) ) );
+			const char * argv[] = { "program", "--log-level=high" };
+			auto result = binder.apply( scope, 2, argv );
+
+			REQUIRE_FALSE( result );
+			REQUIRE( result.applied == 0 );
+			REQUIRE( result.defined == std::vector<std::string>{ "--log-level=high" } );
+			REQUIRE( dynaconf::get<Level>( scope )->value() == 5 );
+		}
+
+		THEN( "the command line should override the environment" )
+		{
+			const char * environment[] = { "PATH=/bin", "APP_LOG_LEVEL=high", "APP_CONNECTION=ZMQ", "APP_COLOR=red", nullptr };
+			const char * argv[] = { "program", "--connection=TCP" };
+			auto result = binder.apply( scope, 2, argv, environment, "APP_" );
+
+			REQUIRE( result.applied == 2 );
+			REQUIRE( result.unknown == std::vector<std::string>{ "APP_COLOR=red" } );
+			REQUIRE( dynaconf::get<Connection>( scope )->value() == "tcp" );
+			REQUIRE( dynaconf::get<Level>( scope )->value() == 10 );
+		}
+	}
+}
@@ -0,0 +1,197 @@
+#include <catch.hpp>
+#include <dynaconf/include/Scope.h>
+
+struct WatchedType {};
+struct OtherType {};
+
+SCENARIO( "subscriptions should report new definitions in scope and ancestors" )
+{
+	GIVEN( "dependent scopes, a notifier, and a subscription on the child" )
+	{
+		auto notifier = std::make_shared<dynaconf::Notifier>();
+		auto scope = std::make_shared<dynaconf::Scope>();
+		auto child = std::make_shared<dynaconf::Scope>( scope );
+
+		std::mutex mutex;
+		std::vector<std::type_index> changes;
+		auto record = [&]( const std::vector<std::type_index> & batch )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			changes.insert( changes.end(), batch.begin(), batch.end() );
+		};
+
+		THEN( "definitions in the child and parent should be delivered" )
+		{
+			auto subscription = child->subscribe( record, notifier );
+			REQUIRE( dynaconf::set( child, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<OtherType>( std::make_shared<OtherType>() ) ) );
+			notifier->drain();
+
+			REQUIRE( changes.size() == 2 );
+			REQUIRE( changes[ 0 ] == std::type_index{ typeid(WatchedType) } );
+			REQUIRE( changes[ 1 ] == std::type_index{ typeid(OtherType) } );
+		}
+
+		THEN( "typed subscriptions should ignore other classes" )
+		{
+			auto subscription = dynaconf::subscribe<WatchedType>( child, record, notifier );
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<OtherType>( std::make_shared<OtherType>() ) ) );
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			notifier->drain();
+
+			REQUIRE( changes.size() == 1 );
+			REQUIRE( changes[ 0 ] == std::type_index{ typeid(WatchedType) } );
+		}
+
+		THEN( "sibling and failed definitions should not be delivered" )
+		{
+			auto sibling = std::make_shared<dynaconf::Scope>( scope );
+			auto subscription = child->subscribe( record, notifier );
+			REQUIRE( dynaconf::set( sibling, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			REQUIRE( dynaconf::set( child, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			REQUIRE_FALSE( dynaconf::set( child, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			notifier->drain();
+
+			REQUIRE( changes.size() == 1 );
+		}
+
+		THEN( "dropping the subscription should stop delivery" )
+		{
+			auto subscription = child->subscribe( record, notifier );
+			subscription.reset();
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+			notifier->drain();
+
+			REQUIRE( changes.empty() );
+		}
+	}
+}
+
+struct WatchedScope : dynaconf::Scope {
+	using dynaconf::Scope::Scope;
+	std::size_t watching( void ) const { return spill ? spill->subscriptions.size() : 0; }
+};
+
+SCENARIO( "dropped subscriptions should not accumulate in ancestors" )
+{
+	GIVEN( "a long-lived parent scope" )
+	{
+		auto notifier = std::make_shared<dynaconf::Notifier>();
+		auto parent = std::make_shared<WatchedScope>();
+		auto held = parent->subscribe( []( const std::vector<std::type_index> & ) {}, notifier );
+
+		THEN( "repeatedly subscribing and dropping from children should stay bounded" )
+		{
+			for( int iteration = 0; iteration < 10000; ++iteration )
+			{
+				auto child = std::make_shared<dynaconf::Scope>( parent );
+				auto subscription = child->subscribe( []( const std::vector<std::type_index> & ) {}, notifier );
+			}
+			REQUIRE( parent->watching() <= 2 );
+		}
+	}
+}
+
+SCENARIO( "callbacks should be able to release the last notifier and subscription handles" )
+{
+	GIVEN( "a subscription whose callback holds the only handles" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		std::mutex mutex;
+		std::condition_variable released;
+		bool done = false;
+		std::shared_ptr<dynaconf::Notifier> notifier = std::make_shared<dynaconf::Notifier>();
+		std::shared_ptr<dynaconf::Subscription> subscription;
+
+		auto drop = [&]( const std::vector<std::type_index> & )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			subscription.reset();
+			notifier.reset();
+			done = true;
+			released.notify_all();
+		};
+
+		THEN( "dropping them during delivery should neither deadlock nor crash" )
+		{
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				subscription = scope->subscribe( drop, notifier );
+			}
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<WatchedType>( std::make_shared<WatchedType>() ) ) );
+
+			std::unique_lock<std::mutex> lock( mutex );
+			released.wait( lock, [&]{ return done; } );
+			REQUIRE_FALSE( notifier );
+			REQUIRE_FALSE( subscription );
+		}
+	}
+}
+
+struct PendingSubscription : dynaconf::Subscription {
+	using dynaconf::Subscription::Subscription;
+	std::size_t backlog( void ) { std::unique_lock<std::mutex> lock( mutex ); return pending.size(); }
+	bool queued( void ) { std::unique_lock<std::mutex> lock( mutex ); return scheduled; }
+};
+
+SCENARIO( "subscriptions should coalesce changes and drop them without a notifier" )
+{
+	GIVEN( "a subscription on a notifier" )
+	{
+		auto notifier = std::make_shared<dynaconf::Notifier>();
+		std::mutex mutex;
+		std::condition_variable signal;
+		bool entered = false, released = false;
+		std::vector< std::vector<std::type_index> > batches;
+		auto subscription = std::make_shared<PendingSubscription>( [&]( const std::vector<std::type_index> & batch )
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			batches.push_back( batch );
+			entered = true;
+			signal.notify_all();
+			signal.wait( lock, [&]{ return released; } );
+		}, notifier );
+
+		THEN( "repeated changes to a class should arrive once per batch" )
+		{
+			subscription->post( std::type_index{ typeid(OtherType) } );
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				signal.wait( lock, [&]{ return entered; } );
+			}
+
+			// First delivery is blocked; these accumulate into the next.
+			//
+			for( int change = 0; change < 3; ++change )
+			{
+				subscription->post( std::type_index{ typeid(WatchedType) } );
+			}
+			REQUIRE( subscription->backlog() == 1 );
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				released = true;
+				signal.notify_all();
+			}
+			notifier->drain();
+
+			REQUIRE( batches.size() == 2 );
+			REQUIRE( batches[ 1 ] == std::vector<std::type_index>{ std::type_index{ typeid(WatchedType) } } );
+		}
+
+		THEN( "changes posted after the notifier is destroyed should be dropped" )
+		{
+			{
+				std::unique_lock<std::mutex> lock( mutex );
+				released = true;
+			}
+			notifier.reset();
+			for( int change = 0; change < 3; ++change )
+			{
+				subscription->post( std::type_index{ typeid(WatchedType) } );
+			}
+			REQUIRE( subscription->backlog() == 0 );
+			REQUIRE_FALSE( subscription->queued() );
+		}
+	}
+}
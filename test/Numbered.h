@@ -0,0 +1,24 @@
+#pragma once
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include <dynaconf/include/Definition.h>
+
+template < std::size_t Number >
+struct NumberedType {};
+
+/// Append definitions of NumberedType<0> through NumberedType<Count - 1>.
+///
+template < std::size_t Count >
+struct Numbered {
+	static void define( std::vector< dynaconf::Reference<dynaconf::Definition> > & definitions )
+	{
+		Numbered< Count - 1 >::define( definitions );
+		definitions.emplace_back( dynaconf::make_singleton< NumberedType< Count - 1 > >( std::make_shared< NumberedType< Count - 1 > >() ) );
+	}
+};
+
+template <>
+struct Numbered<0> {
+	static void define( std::vector< dynaconf::Reference<dynaconf::Definition> > & ) {}
+};
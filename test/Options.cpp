@@ -1,8 +1,16 @@
 #include <catch.hpp>
 #include <dynaconf/include/Options.h>
 #include <dynaconf/include/NamedType.h>
+#include <dlfcn.h>
+#include "Plugin.h"
 
 using ValueType = dynaconf::NamedType<int, struct ValueTypeParameter >;
+using LegacyType = dynaconf::NamedType<int, struct LegacyTypeParameter >;
+
+// Exported through the shared_ptr overload and released by Options::Global
+// during exit.
+//
+static dynaconf::Options::Export legacy( std::make_shared< dynaconf::Singleton<LegacyType> >( std::make_shared<LegacyType>( 7 ) ), "legacy" );
 
 SCENARIO( "options should provide for multiple named definitions of object" )
 {
@@ -38,5 +46,110 @@ SCENARIO( "options should provide for multiple named definitions of object" )
 			REQUIRE( dynaconf::set<ValueType>( scope, "1", options ) );
 			REQUIRE( dynaconf::get<ValueType>( scope )->value() == 1 );
 		}
+
+		THEN( "batched resolution should match single lookups" )
+		{
+			dynaconf::set( options, "1", dynaconf::make_singleton<ValueType>( std::make_shared<ValueType>( 1 ) ) );
+			dynaconf::set( options, "a key longer than small-string storage", dynaconf::make_singleton<ValueType>( std::make_shared<ValueType>( 2 ) ) );
+
+			const std::type_index index{ typeid(ValueType) };
+			auto resolved = options->resolve( { { index, "1" }, { index, "a key longer than small-string storage" }, { index, "missing" } } );
+
+			REQUIRE( resolved.size() == 3 );
+			REQUIRE( resolved[ 0 ] == options->resolve( index, "1" ) );
+			REQUIRE( resolved[ 1 ] == options->resolve( index, "a key longer than small-string storage" ) );
+			REQUIRE( resolved[ 2 ] == nullptr );
+		}
+	}
+}
+
+SCENARIO( "shared_ptr definitions exported to the global options should stay usable" )
+{
+	GIVEN( "a static export of a shared_ptr definition and a scope" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		THEN( "the export should be selectable" )
+		{
+			REQUIRE( legacy.valid );
+			REQUIRE( dynaconf::set<LegacyType>( scope, "legacy", dynaconf::Options::Global ) );
+			REQUIRE( dynaconf::get<LegacyType>( scope )->value() == 7 );
+		}
+	}
+}
+
+using ExportedType = dynaconf::NamedType<int, struct ExportedTypeParameter >;
+
+static bool built = false;
+
+DYNACONF_EXPORT( exportedFirst, "first", ( built = true, dynaconf::make_singleton<ExportedType>( std::make_shared<ExportedType>( 1 ) ) ) );
+DYNACONF_EXPORT( exportedSecond, "second", dynaconf::make_singleton<ExportedType>( std::make_shared<ExportedType>( 2 ) ) );
+
+// Static exports to the global options must not index the tables above,
+// which would build them before main depending on link order.
+//
+static dynaconf::Options::Export overriding( dynaconf::make_singleton<LegacyType>( std::make_shared<LegacyType>( 8 ) ), "overriding" );
+static const bool builtDuringInit = built;
+
+SCENARIO( "link-time exports should be indexed by the global options" )
+{
+	GIVEN( "exported definitions and a configuration scope" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		THEN( "exports should resolve from the global options only" )
+		{
+			REQUIRE( dynaconf::get<ExportedType>( dynaconf::Options::Global, "first" ) != nullptr );
+			REQUIRE( dynaconf::get<ExportedType>( std::make_shared<dynaconf::Options>(), "first" ) == nullptr );
+
+			REQUIRE( dynaconf::set<ExportedType>( scope, "second", dynaconf::Options::Global ) );
+			REQUIRE( dynaconf::get<ExportedType>( scope )->value() == 2 );
+		}
+
+		THEN( "static-init exports should not build export records" )
+		{
+			REQUIRE( overriding.valid );
+			REQUIRE_FALSE( builtDuringInit );
+		}
+
+		THEN( "explicit definitions should win over records indexed before or after" )
+		{
+			auto value = []( const std::shared_ptr<dynaconf::Options> & options )
+			{
+				return dynaconf::get<ExportedType>( options, "first" )->instantiate( nullptr )->value();
+			};
+
+			auto before = std::make_shared<dynaconf::Options>( true );
+			REQUIRE( dynaconf::set( before, "first", dynaconf::make_singleton<ExportedType>( std::make_shared<ExportedType>( 10 ) ) ) );
+			REQUIRE( value( before ) == 10 );
+
+			auto after = std::make_shared<dynaconf::Options>( true );
+			REQUIRE( value( after ) == 1 );
+			REQUIRE( dynaconf::set( after, "first", dynaconf::make_singleton<ExportedType>( std::make_shared<ExportedType>( 20 ) ) ) );
+			REQUIRE( value( after ) == 20 );
+			REQUIRE_FALSE( dynaconf::set( after, "first", dynaconf::make_singleton<ExportedType>( std::make_shared<ExportedType>( 30 ) ) ) );
+			REQUIRE( value( after ) == 20 );
+		}
+	}
+}
+
+SCENARIO( "exports of dlopen()ed plugins should be indexed and outlive dlclose()" )
+{
+	GIVEN( "a plugin exporting a definition" )
+	{
+		REQUIRE( dynaconf::get<PluginType>( dynaconf::Options::Global, "plugin" ) == nullptr );
+
+		void * plugin = dlopen( DYNACONF_TEST_PLUGIN, RTLD_NOW | RTLD_LOCAL );
+		REQUIRE( plugin != nullptr );
+
+		THEN( "the export should resolve, and stay usable once the plugin is closed" )
+		{
+			auto scope = std::make_shared<dynaconf::Scope>();
+			REQUIRE( dynaconf::set<PluginType>( scope, "plugin", dynaconf::Options::Global ) );
+			REQUIRE( dlclose( plugin ) == 0 );
+
+			REQUIRE( dlopen( DYNACONF_TEST_PLUGIN, RTLD_NOW | RTLD_NOLOAD ) != nullptr );
+			REQUIRE( dynaconf::get<PluginType>( scope )->value() == 42 );
+		}
 	}
 }
@@ -0,0 +1,6 @@
+#pragma once
+#include <dynaconf/include/NamedType.h>
+
+/// Class exported by the test plugin, which the tests dlopen().
+///
+using PluginType = dynaconf::NamedType<int, struct PluginTypeParameter >;
@@ -0,0 +1,112 @@
+#include <catch.hpp>
+#include <dynaconf/include/Scope.h>
+
+struct CountedDefinition : dynaconf::Definition {
+	CountedDefinition( bool & flag ) : destroyed( flag ) {}
+	virtual ~CountedDefinition() { destroyed = true; }
+	virtual std::type_index index( void ) const { return std::type_index{typeid(CountedDefinition)}; }
+	bool & destroyed;
+};
+
+SCENARIO( "references should own definitions through an embedded count" )
+{
+	GIVEN( "a referenced definition" )
+	{
+		bool destroyed = false;
+		auto reference = dynaconf::make_reference<CountedDefinition>( destroyed );
+
+		THEN( "references should be a single pointer" )
+		{
+			REQUIRE( sizeof( reference ) == sizeof( void * ) );
+		}
+
+		THEN( "the definition should live until the last reference is dropped" )
+		{
+			dynaconf::Reference<dynaconf::Definition> base{ reference };
+			REQUIRE( base == reference );
+
+			reference.reset();
+			REQUIRE( reference == nullptr );
+			REQUIRE_FALSE( destroyed );
+
+			auto copy = base;
+			base.reset();
+			REQUIRE_FALSE( destroyed );
+
+			copy.reset();
+			REQUIRE( destroyed );
+		}
+
+		THEN( "casts should share ownership" )
+		{
+			dynaconf::Reference<dynaconf::Definition> base{ std::move( reference ) };
+			REQUIRE( reference == nullptr );
+
+			auto derived = dynaconf::dynamic_reference_cast<CountedDefinition>( base );
+			REQUIRE( derived == base );
+			REQUIRE( dynaconf::dynamic_reference_cast< dynaconf::Provider<int> >( base ) == nullptr );
+
+			base.reset();
+			REQUIRE_FALSE( destroyed );
+			derived.reset();
+			REQUIRE( destroyed );
+		}
+	}
+}
+
+struct SharedType {};
+
+SCENARIO( "shared_ptr call sites should keep working with references" )
+{
+	GIVEN( "a scope" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		THEN( "singletons should convert to shared_ptr and set" )
+		{
+			std::shared_ptr< dynaconf::Singleton<SharedType> > singleton = dynaconf::make_singleton<SharedType>( std::make_shared<SharedType>() );
+			REQUIRE( dynaconf::set( scope, singleton ) );
+			REQUIRE( scope->resolve( std::type_index{ typeid(SharedType) } ) == singleton );
+		}
+
+		THEN( "temporary shared_ptr definitions should set" )
+		{
+			bool destroyed = false;
+			REQUIRE( dynaconf::set( scope, std::shared_ptr<CountedDefinition>( new CountedDefinition( destroyed ) ) ) );
+			REQUIRE_FALSE( destroyed );
+			scope.reset();
+			REQUIRE( destroyed );
+		}
+
+		THEN( "definitions owned by shared_ptr should be adopted until both owners are done" )
+		{
+			bool destroyed = false;
+			auto shared = std::shared_ptr<CountedDefinition>( new CountedDefinition( destroyed ) );
+			std::weak_ptr<CountedDefinition> weak{ shared };
+			{
+				dynaconf::Reference<dynaconf::Definition> reference{ shared };
+				REQUIRE( reference == shared );
+
+				shared.reset();
+				REQUIRE_FALSE( destroyed );
+				REQUIRE_FALSE( weak.expired() );
+			}
+			REQUIRE( destroyed );
+		}
+
+		THEN( "converted references should round trip without double counting" )
+		{
+			bool destroyed = false;
+			auto reference = dynaconf::make_reference<CountedDefinition>( destroyed );
+			std::shared_ptr<dynaconf::Definition> shared = reference;
+			dynaconf::Reference<dynaconf::Definition> back{ shared };
+			REQUIRE( back == reference );
+
+			reference.reset();
+			shared.reset();
+			REQUIRE_FALSE( destroyed );
+			back.reset();
+			REQUIRE( destroyed );
+		}
+	}
+}
@@ -0,0 +1,163 @@
+#include <catch.hpp>
+#include <dynaconf/include/Replicated.h>
+#include <thread>
+
+struct Counter { unsigned int count; };
+
+SCENARIO( "replicated providers should give each thread or CPU its own instance" )
+{
+	GIVEN( "a scope and a counting functor" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+		auto functor = []( const std::shared_ptr<const dynaconf::Scope> & ) { return Counter{ 0 }; };
+
+		auto hammer = [&]( unsigned int threads, unsigned int increments )
+		{
+			std::vector<std::thread> workers;
+			for( unsigned int thread = 0; thread < threads; ++thread )
+			{
+				workers.emplace_back( [&]
+				{
+					for( unsigned int increment = 0; increment < increments; ++increment )
+					{
+						++dynaconf::get<Counter>( scope )->count;
+					}
+				});
+			}
+			for( auto & worker : workers )
+			{
+				worker.join();
+			}
+		};
+
+		auto total = [&]
+		{
+			unsigned int sum = 0;
+			REQUIRE( dynaconf::visit<Counter>( scope, [&]( Counter & counter ) { sum += counter.count; } ) );
+			return sum;
+		};
+
+		THEN( "per-thread replicas should be stable and each start a cache line" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_thread<Counter>( functor ) ) );
+
+			auto local = dynaconf::get<Counter>( scope );
+			REQUIRE( local == dynaconf::get<Counter>( scope ) );
+
+			std::shared_ptr<Counter> remote;
+			std::thread( [&]{ remote = dynaconf::get<Counter>( scope ); } ).join();
+			REQUIRE( remote != local );
+
+			const auto line = []( const std::shared_ptr<Counter> & counter ) { return reinterpret_cast<std::uintptr_t>( counter.get() ) / dynaconf::CacheAligned<Counter>::Line; };
+			REQUIRE( line( remote ) != line( local ) );
+			REQUIRE( reinterpret_cast<std::uintptr_t>( local.get() ) % dynaconf::CacheAligned<Counter>::Line == 0 );
+			REQUIRE( reinterpret_cast<std::uintptr_t>( remote.get() ) % dynaconf::CacheAligned<Counter>::Line == 0 );
+			REQUIRE( dynaconf::get<Counter>( scope ) == local );
+		}
+
+		THEN( "per-thread replicas should aggregate via visit" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_thread<Counter>( functor ) ) );
+			hammer( 4, 1000 );
+			REQUIRE( total() == 4000 );
+		}
+
+		THEN( "per-cpu replicas should be visitable" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_cpu<Counter>( functor ) ) );
+			auto local = dynaconf::get<Counter>( scope );
+			REQUIRE( local != nullptr );
+			local->count = 7;
+			REQUIRE( total() == 7 );
+		}
+
+		THEN( "local lookups should match get and aggregate via visit" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_thread<Counter>( functor ) ) );
+			auto counters = dynaconf::get_replicated<Counter>( scope );
+			REQUIRE( counters != nullptr );
+			REQUIRE( &counters->local( scope ) == dynaconf::get<Counter>( scope ).get() );
+
+			std::vector<std::thread> workers;
+			for( unsigned int thread = 0; thread < 4; ++thread )
+			{
+				workers.emplace_back( [&]
+				{
+					for( unsigned int increment = 0; increment < 1000; ++increment )
+					{
+						++counters->local( scope ).count;
+					}
+				});
+			}
+			for( auto & worker : workers )
+			{
+				worker.join();
+			}
+			REQUIRE( total() == 4000 );
+		}
+
+		THEN( "retiring should fold and free replicas of exited threads" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_thread<Counter>( functor ) ) );
+			auto survivor = dynaconf::get<Counter>( scope );
+			hammer( 4, 1000 );
+
+			auto counters = dynaconf::get_replicated<Counter>( scope );
+			REQUIRE( counters->retire( [&]( Counter & counter ) { survivor->count += counter.count; } ) == 4 );
+			REQUIRE( counters->retire( []( Counter & ) {} ) == 0 );
+			REQUIRE( survivor->count == 4000 );
+			REQUIRE( total() == 4000 );
+		}
+
+		THEN( "visit should fail without a replicated definition" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_singleton<Counter>( std::make_shared<Counter>() ) ) );
+			REQUIRE_FALSE( dynaconf::visit<Counter>( scope, []( Counter & ) {} ) );
+			REQUIRE( dynaconf::get_replicated<Counter>( scope ) == nullptr );
+		}
+	}
+}
+
+struct AtomicCounter { std::atomic<unsigned int> count{ 0 }; };
+
+SCENARIO( "replicated providers should build non-movable classes in place" )
+{
+	GIVEN( "a scope and a class holding an atomic" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		THEN( "per-cpu atomic counters should aggregate exactly" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_cpu<AtomicCounter>() ) );
+
+			std::vector<std::thread> workers;
+			for( unsigned int thread = 0; thread < 4; ++thread )
+			{
+				workers.emplace_back( [&]
+				{
+					for( unsigned int increment = 0; increment < 1000; ++increment )
+					{
+						dynaconf::get<AtomicCounter>( scope )->count.fetch_add( 1, std::memory_order_relaxed );
+					}
+				});
+			}
+			for( auto & worker : workers )
+			{
+				worker.join();
+			}
+
+			unsigned int sum = 0;
+			REQUIRE( dynaconf::visit<AtomicCounter>( scope, [&]( AtomicCounter & counter ) { sum += counter.count.load(); } ) );
+			REQUIRE( sum == 4000 );
+		}
+
+		THEN( "initializing functors should see the in-place replica" )
+		{
+			REQUIRE( dynaconf::set( scope, dynaconf::make_per_thread<AtomicCounter>( []( AtomicCounter & counter, const std::shared_ptr<const dynaconf::Scope> & )
+			{
+				counter.count = 5;
+			})));
+			REQUIRE( dynaconf::get<AtomicCounter>( scope )->count == 5 );
+		}
+	}
+}
@@ -1,5 +1,8 @@
 #include <catch.hpp>
 #include <dynaconf/include/Scope.h>
+#include <atomic>
+#include <thread>
+#include "Numbered.h"
 
 template < typename Type>
 struct TestDefinition : dynaconf::Definition {
@@ -77,6 +80,61 @@ SCENARIO( "the Singleton class should provide a single return value" )
 	}
 }
 
+struct TrackedType {
+	TrackedType( bool & flag ) : destroyed( flag ) {}
+	~TrackedType() { destroyed = true; }
+	bool & destroyed;
+};
+
+SCENARIO( "the InlineSingleton class should provide an instance stored in its definition" )
+{
+	GIVEN( "a scope and an inline singleton" )
+	{
+		bool destroyed = false;
+		auto scope = std::make_shared<dynaconf::Scope>();
+		auto child = std::make_shared<dynaconf::Scope>( scope );
+		REQUIRE( dynaconf::set( scope, dynaconf::make_inline_singleton<TrackedType>( destroyed ) ) );
+
+		THEN( "the return value shouldn't vary" )
+		{
+			REQUIRE( dynaconf::get<TrackedType>( child ) == dynaconf::get<TrackedType>( scope ) );
+		}
+
+		THEN( "instances should keep the definition alive" )
+		{
+			auto instance = dynaconf::get<TrackedType>( scope );
+			scope.reset();
+			child.reset();
+			REQUIRE_FALSE( destroyed );
+
+			instance.reset();
+			REQUIRE( destroyed );
+		}
+	}
+
+	GIVEN( "an inline singleton held through a shared_ptr" )
+	{
+		bool destroyed = false;
+		std::shared_ptr< dynaconf::Provider<TrackedType> > provider = dynaconf::make_inline_singleton<TrackedType>( destroyed );
+
+		THEN( "it should only be constructible as a Reference" )
+		{
+			REQUIRE_FALSE( std::is_constructible< dynaconf::InlineSingleton<TrackedType>, bool & >::value );
+			REQUIRE_FALSE( std::is_copy_constructible< dynaconf::InlineSingleton<TrackedType> >::value );
+		}
+
+		THEN( "instantiating outside a scope should share the definition" )
+		{
+			auto instance = provider->instantiate( nullptr );
+			provider.reset();
+			REQUIRE_FALSE( destroyed );
+
+			instance.reset();
+			REQUIRE( destroyed );
+		}
+	}
+}
+
 SCENARIO( "the Factory class should allow for scope based construction" )
 {
 	GIVEN( "dependent scopes, a factory, and sentinel values" )
@@ -112,3 +170,115 @@ SCENARIO( "the Factory class should allow for scope based construction" )
 		}
 	}
 }
+
+struct OtherTestType {};
+
+SCENARIO( "scopes should define batches under a single lock" )
+{
+	GIVEN( "a scope already defining one class of a batch" )
+	{
+		auto scope = std::make_shared<dynaconf::Scope>();
+		auto existing = dynaconf::Reference<dynaconf::Definition>( new TestDefinition<TestType>{} );
+		auto skipped = dynaconf::Reference<dynaconf::Definition>( new TestDefinition<TestType>{} );
+		auto added = dynaconf::Reference<dynaconf::Definition>( new TestDefinition<OtherTestType>{} );
+		REQUIRE( scope->define( existing ) );
+
+		THEN( "new classes should be moved in and defined ones left in the batch" )
+		{
+			std::vector< dynaconf::Reference<dynaconf::Definition> > batch{ skipped, added };
+			REQUIRE( scope->define( batch ) == 1 );
+			REQUIRE( batch[ 0 ] == skipped );
+			REQUIRE( batch[ 1 ] == nullptr );
+			REQUIRE( scope->resolve( std::type_index{ typeid(TestType) } ) == existing );
+			REQUIRE( scope->resolve( std::type_index{ typeid(OtherTestType) } ) == added );
+		}
+	}
+}
+
+SCENARIO( "scopes should hold many definitions beyond inline storage" )
+{
+	GIVEN( "a scope and more definitions than fit inline" )
+	{
+		std::vector< dynaconf::Reference<dynaconf::Definition> > definitions;
+		Numbered< dynaconf::Scope::Inline + 4 >::define( definitions );
+		REQUIRE( definitions.size() > dynaconf::Scope::Inline );
+
+		auto scope = std::make_shared<dynaconf::Scope>();
+		auto child = std::make_shared<dynaconf::Scope>( scope );
+
+		THEN( "every definition should be definable once and resolvable" )
+		{
+			for( auto & definition : definitions )
+			{
+				REQUIRE( scope->define( definition ) );
+			}
+			for( auto & definition : definitions )
+			{
+				REQUIRE_FALSE( scope->define( definition ) );
+				REQUIRE( scope->resolve( definition->index() ) == definition );
+				REQUIRE( child->resolve( definition->index() ) == definition );
+			}
+		}
+
+		THEN( "batch definition should skip existing classes" )
+		{
+			REQUIRE( scope->define( definitions.back() ) );
+			auto batch = definitions;
+			REQUIRE( scope->define( batch ) == definitions.size() - 1 );
+			REQUIRE( scope->resolve( definitions.front()->index() ) == definitions.front() );
+			REQUIRE( batch.back() == definitions.back() );
+		}
+
+		THEN( "batch definition should leave duplicates of overflowed classes in place" )
+		{
+			for( auto & definition : definitions )
+			{
+				REQUIRE( scope->define( definition ) );
+			}
+			std::vector< dynaconf::Reference<dynaconf::Definition> > batch{ definitions.back() };
+			REQUIRE( scope->define( batch ) == 0 );
+			REQUIRE( batch.front() == definitions.back() );
+			REQUIRE( scope->resolve( definitions.back()->index() ) == definitions.back() );
+		}
+	}
+}
+
+SCENARIO( "scopes should serialize concurrent definition and resolution" )
+{
+	GIVEN( "a scope and several threads defining the same classes" )
+	{
+		std::vector< dynaconf::Reference<dynaconf::Definition> > definitions;
+		Numbered< dynaconf::Scope::Inline + 4 >::define( definitions );
+		auto scope = std::make_shared<dynaconf::Scope>();
+
+		THEN( "each class should be defined exactly once and stay resolvable" )
+		{
+			std::atomic<std::size_t> defined{ 0 };
+			std::atomic<std::size_t> missing{ 0 };
+			std::vector<std::thread> workers;
+			for( unsigned int thread = 0; thread < 4; ++thread )
+			{
+				workers.emplace_back( [&]
+				{
+					for( auto & definition : definitions )
+					{
+						if( scope->define( definition ) )
+						{
+							++defined;
+						}
+						if( scope->resolve( definition->index() ) != definition )
+						{
+							++missing;
+						}
+					}
+				});
+			}
+			for( auto & worker : workers )
+			{
+				worker.join();
+			}
+			REQUIRE( defined == definitions.size() );
+			REQUIRE( missing == 0 );
+		}
+	}
+}
@@ -0,0 +1,229 @@
+#include <dynaconf/include/Scope.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace dynaconf;
+
+template < int Number >
+struct Slot {};
+
+static constexpr std::uintptr_t Line = 64;	///< Assumed cache line size.
+
+static std::size_t allocated = 0;	///< Size of the last Counting allocation.
+
+/// Allocator recording the size of each allocation.
+///
+template < typename Type >
+struct Counting {
+	using value_type = Type;
+
+	Counting( void ) {}
+
+	template < typename Other >
+	Counting( const Counting<Other> & ) {}
+
+	Type * allocate( std::size_t count )
+	{
+		allocated = count * sizeof( Type );
+		return std::allocator<Type>{}.allocate( count );
+	}
+
+	void deallocate( Type * pointer, std::size_t count ) { std::allocator<Type>{}.deallocate( pointer, count ); }
+
+	template < typename Other >
+	bool operator == ( const Counting<Other> & ) const { return true; }
+
+	template < typename Other >
+	bool operator != ( const Counting<Other> & ) const { return false; }
+};
+
+/// Cache lines spanned by an object.
+///
+/// @param object to measure.
+/// @param size of the object.
+/// @return lines touched by reading all of it.
+///
+std::uintptr_t span( const void * object, std::size_t size )
+{
+	const auto first = reinterpret_cast<std::uintptr_t>( object );
+	return ( first + size - 1 ) / Line - first / Line + 1;
+}
+
+/// Exposes the layout of a scope's lock and inline entries.
+///
+struct Probe : Scope {
+	using Scope::Scope;
+
+	/// Cache lines holding the lock and the first count entries.
+	///
+	/// @param count of entries scanned.
+	/// @return lines touched in the scope by a lookup.
+	///
+	std::uintptr_t lines( std::size_t count ) const
+	{
+		const auto first = std::min( reinterpret_cast<std::uintptr_t>( &mutex ), reinterpret_cast<std::uintptr_t>( &entries[ 0 ] ) );
+		const auto last = std::max( reinterpret_cast<std::uintptr_t>( &mutex + 1 ), reinterpret_cast<std::uintptr_t>( &entries[ count ] ) ) - 1;
+		return last / Line - first / Line + 1;
+	}
+
+	/// Cache lines spanned by the whole scope.
+	///
+	/// @return lines touched by creating and destroying the scope.
+	///
+	std::uintptr_t span( void ) const
+	{
+		return ::span( this, sizeof( Scope ) );
+	}
+};
+
+/// Time an operation, reporting the best nanoseconds per iteration.
+///
+/// The fastest of several rounds filters out preemption on shared hosts.
+///
+/// @param name of the operation.
+/// @param iterations to run per round.
+/// @param operation to time.
+///
+template < typename Operation >
+void measure( const char * name, long iterations, Operation operation )
+{
+	auto best = std::chrono::steady_clock::duration::max();
+	for( int round = 0; round < 7; ++round )
+	{
+		const auto start = std::chrono::steady_clock::now();
+		for( long iteration = 0; iteration < iterations; ++iteration )
+		{
+			operation();
+		}
+		best = std::min( best, std::chrono::steady_clock::now() - start );
+	}
+	const auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>( best ).count();
+	std::printf( "%-36s %8.1f ns/op\n", name, static_cast<double>( nanoseconds ) / static_cast<double>( iterations ) );
+}
+
+int main( void )
+{
+	// glibc's malloc skips its arena locks until a second thread exists;
+	// measure the multi-threaded case scopes are built for.
+	//
+	std::thread( []{} ).join();
+
+	const long iterations = 1000000;
+	std::printf( "%-36s %8zu bytes\n", "sizeof( Scope )", sizeof( Scope ) );
+
+	// make_shared places a control block ahead of the scope, and malloc
+	// aligns to 16 bytes rather than a line--report what a scope costs.
+	//
+	std::allocate_shared<Scope>( Counting<Scope>{} );
+	std::printf( "%-36s %8zu bytes\n", "make_shared<Scope> allocation", allocated );
+
+	std::vector< std::shared_ptr<Probe> > probes;
+	std::uintptr_t spanned = 0, scanned = 0, crowded = 0, misaligned = 0;
+	for( int count = 0; count < 1000; ++count )
+	{
+		probes.push_back( std::make_shared<Probe>() );
+		spanned += probes.back()->span();
+		scanned += probes.back()->lines( 3 );
+		crowded += probes.back()->lines( std::min<std::size_t>( 8, Scope::Inline ) );
+		misaligned += reinterpret_cast<std::uintptr_t>( probes.back().get() ) % Line;
+	}
+	std::printf( "%-36s %8.2f bytes\n", "mean scope offset into its line", static_cast<double>( misaligned ) / 1000.0 );
+	std::printf( "%-36s %8.2f lines\n", "mean lines spanned by a scope", static_cast<double>( spanned ) / 1000.0 );
+	std::printf( "%-36s %8.2f lines\n", "mean scope lines per third-slot hit", static_cast<double>( scanned ) / 1000.0 );
+	std::printf( "%-36s %8.2f lines\n", "mean scope lines per eighth-slot hit", static_cast<double>( crowded ) / 1000.0 );
+	probes.clear();
+
+	// A hit also takes a reference, touching the definition itself.
+	//
+	std::vector< Reference< Singleton<Slot<0>> > > definitions;
+	std::uintptr_t touched = 0;
+	for( int count = 0; count < 1000; ++count )
+	{
+		definitions.push_back( make_singleton<Slot<0>>( std::make_shared<Slot<0>>() ) );
+		touched += span( definitions.back().get(), sizeof( Singleton<Slot<0>> ) );
+	}
+	std::printf( "%-36s %8.2f lines\n", "mean lines spanned by a definition", static_cast<double>( touched ) / 1000.0 );
+	definitions.clear();
+
+	std::vector< Reference<Definition> > slots;
+	slots.emplace_back( make_singleton<Slot<0>>( std::make_shared<Slot<0>>() ) );
+	slots.emplace_back( make_singleton<Slot<1>>( std::make_shared<Slot<1>>() ) );
+	slots.emplace_back( make_singleton<Slot<2>>( std::make_shared<Slot<2>>() ) );
+	slots.emplace_back( make_singleton<Slot<3>>( std::make_shared<Slot<3>>() ) );
+	slots.emplace_back( make_singleton<Slot<4>>( std::make_shared<Slot<4>>() ) );
+	slots.emplace_back( make_singleton<Slot<5>>( std::make_shared<Slot<5>>() ) );
+	slots.emplace_back( make_singleton<Slot<6>>( std::make_shared<Slot<6>>() ) );
+	slots.emplace_back( make_singleton<Slot<7>>( std::make_shared<Slot<7>>() ) );
+
+	/// Create a scope holding the first count slots.
+	///
+	auto fill = [&]( std::size_t count )
+	{
+		auto scope = std::make_shared<Scope>();
+		for( std::size_t slot = 0; slot < count; ++slot )
+		{
+			scope->define( slots[ slot ] );
+		}
+		return scope;
+	};
+
+	// Short-lived scope with a few definitions--the common case.
+	//
+	measure( "create, define 3, resolve, destroy", iterations / 10, [&]( void )
+	{
+		if( ! fill( 3 )->resolve( std::type_index{ typeid(Slot<2>) } ) )
+		{
+			std::abort();
+		}
+	});
+
+	measure( "create, define 8, resolve, destroy", iterations / 10, [&]( void )
+	{
+		if( ! fill( 8 )->resolve( std::type_index{ typeid(Slot<7>) } ) )
+		{
+			std::abort();
+		}
+	});
+
+	auto scope = fill( 3 );
+	auto child = std::make_shared<Scope>( scope );
+	auto crowd = fill( 8 );
+
+	measure( "resolve hit", iterations, [&]( void )
+	{
+		if( ! scope->resolve( std::type_index{ typeid(Slot<2>) } ) )
+		{
+			std::abort();
+		}
+	});
+
+	measure( "resolve hit in parent", iterations, [&]( void )
+	{
+		if( ! child->resolve( std::type_index{ typeid(Slot<2>) } ) )
+		{
+			std::abort();
+		}
+	});
+
+	measure( "resolve eighth definition", iterations, [&]( void )
+	{
+		if( ! crowd->resolve( std::type_index{ typeid(Slot<7>) } ) )
+		{
+			std::abort();
+		}
+	});
+
+	measure( "get instance", iterations, [&]( void )
+	{
+		if( ! get<Slot<2>>( scope ) )
+		{
+			std::abort();
+		}
+	});
+	return 0;
+}
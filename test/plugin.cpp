@@ -0,0 +1,4 @@
+#include <dynaconf/include/Options.h>
+#include "Plugin.h"
+
+DYNACONF_EXPORT( pluginExport, "plugin", dynaconf::make_singleton<PluginType>( std::make_shared<PluginType>( 42 ) ) );